@@ -23,6 +23,15 @@ struct websocket_handle {
         , user_data(nullptr) {}
 };
 
+// 共享负载句柄结构体
+struct ws_shared_payload {
+    cross_platform_websocket::SharedPayload payload;
+    
+    ws_shared_payload(const char* data, size_t length)
+        : payload(data, length) {
+    }
+};
+
 // 状态转换函数
 static ws_connection_state_t convert_state(cross_platform_websocket::ConnectionState state) {
     switch (state) {
@@ -63,6 +72,16 @@ static void on_error(const std::string& error, void* user_data) {
     }
 }
 
+static cross_platform_websocket::SendCompletionCallback make_completion(
+        websocket_handle_t handle, ws_send_complete_callback_t callback, void* user_data) {
+    if (!callback) {
+        return cross_platform_websocket::SendCompletionCallback();
+    }
+    return [handle, callback, user_data](bool success, const std::string& reason) {
+        callback(handle, success ? 1 : 0, reason.c_str(), user_data);
+    };
+}
+
 // C API 实现
 extern "C" {
 
@@ -135,14 +154,100 @@ int ws_send_text(websocket_handle_t handle, const char* message) {
     }
 }
 
+int ws_send_keyed_text(websocket_handle_t handle, const char* key, const char* message) {
+    if (!handle || !handle->api || !key || !message) {
+        return -1;
+    }
+    
+    try {
+        return handle->api->sendKeyedText(key, message) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
 int ws_send_binary(websocket_handle_t handle, const uint8_t* data, size_t length) {
     if (!handle || !handle->api || !data) {
         return -1;
     }
     
     try {
-        std::vector<uint8_t> binary_data(data, data + length);
-        return handle->api->sendBinary(binary_data) ? 0 : -1;
+        return handle->api->sendBinary(data, length) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int ws_send_text_async(websocket_handle_t handle, const char* message,
+                       ws_send_complete_callback_t callback, void* user_data) {
+    if (!handle || !handle->api || !message) {
+        return -1;
+    }
+    
+    try {
+        return handle->api->sendText(message, make_completion(handle, callback, user_data)) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int ws_send_binary_async(websocket_handle_t handle, const uint8_t* data, size_t length,
+                         ws_send_complete_callback_t callback, void* user_data) {
+    if (!handle || !handle->api || !data) {
+        return -1;
+    }
+    
+    try {
+        return handle->api->sendBinary(data, length, make_completion(handle, callback, user_data)) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+ws_shared_payload_t ws_shared_payload_create(const void* data, size_t length) {
+    if (!data && length > 0) {
+        return nullptr;
+    }
+    
+    try {
+        return new ws_shared_payload(static_cast<const char*>(data), length);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void ws_shared_payload_release(ws_shared_payload_t payload) {
+    delete payload;
+}
+
+int ws_send_shared(websocket_handle_t handle, ws_shared_payload_t payload, int is_binary) {
+    if (!handle || !handle->api || !payload) {
+        return -1;
+    }
+    
+    try {
+        return handle->api->sendShared(payload->payload, is_binary != 0) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int ws_broadcast(const websocket_handle_t* handles, size_t count,
+                 ws_shared_payload_t payload, int is_binary) {
+    if (!handles || !payload) {
+        return -1;
+    }
+    
+    try {
+        std::vector<cross_platform_websocket::WebSocketAPI*> targets;
+        targets.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (handles[i] && handles[i]->api) {
+                targets.push_back(handles[i]->api.get());
+            }
+        }
+        return static_cast<int>(cross_platform_websocket::WebSocketAPI::broadcast(
+            targets, payload->payload, is_binary != 0));
     } catch (...) {
         return -1;
     }
@@ -248,6 +353,185 @@ void ws_enable_message_queue(websocket_handle_t handle, int enabled, size_t max_
     }
 }
 
+void ws_set_message_queue_limits(websocket_handle_t handle, size_t max_bytes,
+                                 ws_queue_overflow_policy_t policy, int block_timeout_ms) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setMessageQueueLimits(
+                max_bytes, static_cast<cross_platform_websocket::QueueOverflowPolicy>(policy),
+                block_timeout_ms);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_enable_message_coalescing(websocket_handle_t handle, int enabled) {
+    if (handle && handle->api) {
+        try {
+            handle->api->enableMessageCoalescing(enabled != 0);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_set_message_ttl(websocket_handle_t handle, ws_message_priority_t priority, uint64_t ttl_ms) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setMessageTTL(
+                static_cast<cross_platform_websocket::MessagePriority>(priority), ttl_ms);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_set_queue_drain_rate(websocket_handle_t handle, double messages_per_second, size_t batch_size) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setQueueDrainRate(messages_per_second, batch_size);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+static cross_platform_websocket::RateLimitOptions make_rate_limit(double messages_per_second,
+                                                                  double message_burst,
+                                                                  double bytes_per_second,
+                                                                  double byte_burst) {
+    cross_platform_websocket::RateLimitOptions options;
+    options.messages_per_second = messages_per_second;
+    options.message_burst = message_burst;
+    options.bytes_per_second = bytes_per_second;
+    options.byte_burst = byte_burst;
+    return options;
+}
+
+void ws_set_rate_limit(websocket_handle_t handle, double messages_per_second, double message_burst,
+                       double bytes_per_second, double byte_burst) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setRateLimit(
+                make_rate_limit(messages_per_second, message_burst, bytes_per_second, byte_burst));
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_set_priority_rate_limit(websocket_handle_t handle, ws_message_priority_t priority,
+                                double messages_per_second, double message_burst,
+                                double bytes_per_second, double byte_burst) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setPriorityRateLimit(
+                static_cast<cross_platform_websocket::MessagePriority>(priority),
+                make_rate_limit(messages_per_second, message_burst, bytes_per_second, byte_burst));
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_set_rate_limit_action(websocket_handle_t handle, ws_rate_limit_action_t action) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setRateLimitAction(
+                static_cast<cross_platform_websocket::RateLimitAction>(action));
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+uint64_t ws_get_throttled_count(websocket_handle_t handle) {
+    if (!handle || !handle->api) {
+        return 0;
+    }
+    
+    try {
+        return handle->api->getThrottledMessageCount();
+    } catch (...) {
+        return 0;
+    }
+}
+
+void ws_enable_fair_scheduling(websocket_handle_t handle, int enabled, size_t fragment_size) {
+    if (handle && handle->api) {
+        try {
+            handle->api->enableFairScheduling(enabled != 0, fragment_size);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_set_priority_weight(websocket_handle_t handle, ws_message_priority_t priority, uint32_t weight) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setPriorityWeight(
+                static_cast<cross_platform_websocket::MessagePriority>(priority), weight);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+int ws_enable_reliable_delivery(websocket_handle_t handle, int enabled,
+                                size_t window_size, size_t max_pending) {
+    if (!handle || !handle->api) {
+        return -1;
+    }
+    
+    try {
+        cross_platform_websocket::ReliableChannelOptions options;
+        options.window_size = window_size;
+        options.max_pending = max_pending;
+        return handle->api->enableReliableDelivery(enabled != 0, options) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int ws_get_buffer_pool_stats(ws_buffer_pool_stats_t* stats) {
+    if (!stats) {
+        return -1;
+    }
+    
+    cross_platform_websocket::BufferPoolStats pool =
+        cross_platform_websocket::BufferPool::instance().getStats();
+    stats->allocations = pool.allocations;
+    stats->releases = pool.releases;
+    stats->thread_cache_hits = pool.thread_cache_hits;
+    stats->shared_hits = pool.shared_hits;
+    stats->system_allocations = pool.system_allocations;
+    stats->system_frees = pool.system_frees;
+    stats->oversize_allocations = pool.oversize_allocations;
+    stats->bytes_in_use = pool.bytes_in_use;
+    stats->bytes_cached = pool.bytes_cached;
+    return 0;
+}
+
+int ws_enable_persistent_queue(websocket_handle_t handle, const char* directory,
+                               size_t segment_size, size_t max_segments, size_t sync_every) {
+    if (!handle || !handle->api || !directory) {
+        return -1;
+    }
+    
+    try {
+        cross_platform_websocket::SegmentLogOptions options;
+        options.directory = directory;
+        options.segment_size = segment_size;
+        options.max_segments = max_segments;
+        options.sync_every = sync_every;
+        return handle->api->enablePersistentQueue(options) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
 void ws_enable_heartbeat(websocket_handle_t handle, int enabled, int interval_ms) {
     if (handle && handle->api) {
         try {
@@ -258,6 +542,71 @@ void ws_enable_heartbeat(websocket_handle_t handle, int enabled, int interval_ms
     }
 }
 
+void ws_set_log_level(websocket_handle_t handle, ws_log_level_t level) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setLogLevel(static_cast<cross_platform_websocket::LogLevel>(level));
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_set_module_log_level(websocket_handle_t handle, ws_log_module_t module, ws_log_level_t level) {
+    if (handle && handle->api) {
+        try {
+            handle->api->setModuleLogLevel(static_cast<cross_platform_websocket::LogModule>(module),
+                                           static_cast<cross_platform_websocket::LogLevel>(level));
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+int ws_enable_async_logging(websocket_handle_t handle, int enabled, size_t capacity,
+                            ws_log_overflow_policy_t policy) {
+    if (!handle || !handle->api) {
+        return -1;
+    }
+    
+    try {
+        cross_platform_websocket::LogOverflowPolicy overflow_policy =
+            policy == WS_LOG_OVERFLOW_BLOCK ? cross_platform_websocket::LogOverflowPolicy::BLOCK
+                                            : cross_platform_websocket::LogOverflowPolicy::DROP;
+        return handle->api->enableAsyncLogging(enabled != 0, capacity, overflow_policy) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+uint64_t ws_get_dropped_log_count(websocket_handle_t handle) {
+    if (!handle || !handle->api) {
+        return 0;
+    }
+    
+    try {
+        return handle->api->getDroppedLogCount();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int ws_enable_binary_logging(websocket_handle_t handle, const char* path) {
+    if (!handle || !handle->api) {
+        return -1;
+    }
+    
+    try {
+        if (!path) {
+            handle->api->disableBinaryLogging();
+            return 0;
+        }
+        return handle->api->enableBinaryLogging(path) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
 size_t ws_get_statistics(websocket_handle_t handle, char* buffer, size_t buffer_size) {
     if (!handle || !handle->api || !buffer || buffer_size == 0) {
         return 0;
@@ -274,6 +623,104 @@ size_t ws_get_statistics(websocket_handle_t handle, char* buffer, size_t buffer_
     }
 }
 
+int ws_get_stats_struct(websocket_handle_t handle, ws_stats_t* stats) {
+    if (!handle || !handle->api || !stats) {
+        return -1;
+    }
+    
+    try {
+        cross_platform_websocket::WebSocketStats source = handle->api->getStats();
+        stats->connection_state = convert_state(source.connection_state);
+        stats->messages_sent = source.messages_sent;
+        stats->messages_failed = source.messages_failed;
+        stats->messages_received = source.messages_received;
+        stats->queued_messages = source.queued_messages;
+        stats->queued_bytes = source.queued_bytes;
+        stats->messages_evicted = source.messages_evicted;
+        stats->messages_expired = source.messages_expired;
+        stats->messages_coalesced = source.messages_coalesced;
+        stats->messages_throttled = source.messages_throttled;
+        stats->scheduled_messages = source.scheduled_messages;
+        stats->link_messages_sent = source.link.messages_sent;
+        stats->link_messages_received = source.link.messages_received;
+        stats->bytes_sent = source.link.bytes_sent;
+        stats->bytes_received = source.link.bytes_received;
+        stats->connected_ms = source.link.connected_ms;
+        stats->reliable_in_flight = source.reliable.in_flight;
+        stats->reliable_pending = source.reliable.pending;
+        stats->reliable_retransmits = source.reliable.retransmits;
+        stats->log_dropped = source.log_dropped;
+        stats->log_suppressed = source.log_suppressed;
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+static void copy_latency_stats(const cross_platform_websocket::LatencyStats& latency,
+                             ws_latency_stats_t* stats) {
+    stats->count = latency.count;
+    stats->min_ns = latency.min_ns;
+    stats->max_ns = latency.max_ns;
+    stats->mean_ns = latency.mean_ns;
+    stats->p50_ns = latency.p50_ns;
+    stats->p90_ns = latency.p90_ns;
+    stats->p99_ns = latency.p99_ns;
+    stats->p999_ns = latency.p999_ns;
+}
+
+int ws_get_latency_stats(websocket_handle_t handle, ws_latency_metric_t metric,
+                         ws_latency_stats_t* stats) {
+    return ws_get_merged_latency_stats(&handle, 1, metric, stats);
+}
+
+int ws_get_merged_latency_stats(const websocket_handle_t* handles, size_t count,
+                                ws_latency_metric_t metric, ws_latency_stats_t* stats) {
+    if (!handles || !stats ||
+        static_cast<size_t>(metric) >= cross_platform_websocket::kLatencyMetricCount) {
+        return -1;
+    }
+    
+    try {
+        cross_platform_websocket::LatencySnapshot merged;
+        bool found = false;
+        for (size_t i = 0; i < count; ++i) {
+            if (handles[i] && handles[i]->api) {
+                merged.merge(handles[i]->api->getLatencySnapshot(
+                    static_cast<cross_platform_websocket::LatencyMetric>(metric)));
+                found = true;
+            }
+        }
+        if (!found) {
+            return -1;
+        }
+        copy_latency_stats(merged.stats(), stats);
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+void ws_reset_latency_stats(websocket_handle_t handle) {
+    if (handle && handle->api) {
+        try {
+            handle->api->resetLatencyStats();
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
+void ws_enable_latency_tracking(websocket_handle_t handle, int enabled) {
+    if (handle && handle->api) {
+        try {
+            handle->api->enableLatencyTracking(enabled != 0);
+        } catch (...) {
+            // 忽略异常
+        }
+    }
+}
+
 void ws_set_config(websocket_handle_t handle, const char* key, const char* value) {
     if (handle && handle->api && key && value) {
         try {
@@ -18,11 +18,140 @@ typedef enum {
     WS_STATE_ERROR = 4
 } ws_connection_state_t;
 
+/**
+ * @brief 消息优先级
+ */
+typedef enum {
+    WS_PRIORITY_LOW = 0,
+    WS_PRIORITY_NORMAL = 1,
+    WS_PRIORITY_HIGH = 2,
+    WS_PRIORITY_URGENT = 3
+} ws_message_priority_t;
+
+/**
+ * @brief 消息队列溢出策略
+ */
+typedef enum {
+    WS_QUEUE_REJECT_NEWEST = 0,          /* 拒绝新消息 */
+    WS_QUEUE_DROP_OLDEST_LOW_FIRST = 1,  /* 从最低优先级开始丢弃最旧的消息 */
+    WS_QUEUE_BLOCK = 2                   /* 阻塞等待队列空间，超时后拒绝 */
+} ws_queue_overflow_policy_t;
+
+/**
+ * @brief 超出发送速率时的处理方式
+ */
+typedef enum {
+    WS_RATE_LIMIT_QUEUE = 0,   /* 加入消息队列，按速率补发 */
+    WS_RATE_LIMIT_REJECT = 1   /* 直接拒绝 */
+} ws_rate_limit_action_t;
+
+/**
+ * @brief 日志级别
+ */
+typedef enum {
+    WS_LOG_LEVEL_DEBUG = 0,
+    WS_LOG_LEVEL_INFO = 1,
+    WS_LOG_LEVEL_WARNING = 2,
+    WS_LOG_LEVEL_ERROR = 3,
+    WS_LOG_LEVEL_OFF = 4
+} ws_log_level_t;
+
+/**
+ * @brief 日志模块
+ */
+typedef enum {
+    WS_LOG_MODULE_GENERAL = 0,
+    WS_LOG_MODULE_API = 1,
+    WS_LOG_MODULE_MANAGER = 2,
+    WS_LOG_MODULE_DATALINK = 3,
+    WS_LOG_MODULE_PLATFORM = 4
+} ws_log_module_t;
+
+/**
+ * @brief 异步日志队列满时的处理策略
+ */
+typedef enum {
+    WS_LOG_OVERFLOW_DROP = 0,   /* 丢弃并计数 */
+    WS_LOG_OVERFLOW_BLOCK = 1   /* 等待后台线程腾出空间 */
+} ws_log_overflow_policy_t;
+
+/**
+ * @brief 消息缓冲池统计信息
+ */
+typedef struct {
+    uint64_t allocations;          /* 分配次数 */
+    uint64_t releases;             /* 释放次数 */
+    uint64_t thread_cache_hits;    /* 线程本地缓存命中次数 */
+    uint64_t shared_hits;          /* 共享空闲列表命中次数 */
+    uint64_t system_allocations;   /* 向系统申请内存的次数 */
+    uint64_t system_frees;         /* 归还系统的次数 */
+    uint64_t oversize_allocations; /* 超大块分配次数 */
+    uint64_t bytes_in_use;         /* 使用中的字节数 */
+    uint64_t bytes_cached;         /* 共享空闲列表缓存的字节数 */
+} ws_buffer_pool_stats_t;
+
+/**
+ * @brief 连接统计计数（由 ws_get_stats_struct 填充）
+ */
+typedef struct {
+    ws_connection_state_t connection_state; /* 连接状态 */
+    uint64_t messages_sent;          /* 发送成功消息数 */
+    uint64_t messages_failed;        /* 发送失败消息数 */
+    uint64_t messages_received;      /* 交给上层的接收消息数 */
+    uint64_t queued_messages;        /* 队列消息数 */
+    uint64_t queued_bytes;           /* 队列字节数 */
+    uint64_t messages_evicted;       /* 队列溢出丢弃数 */
+    uint64_t messages_expired;       /* 队列过期丢弃数 */
+    uint64_t messages_coalesced;     /* 队列合并替换数 */
+    uint64_t messages_throttled;     /* 限速节流数 */
+    uint64_t scheduled_messages;     /* 公平调度队列消息数 */
+    uint64_t link_messages_sent;     /* 写入传输层的消息数（含可靠通道重传和确认） */
+    uint64_t link_messages_received; /* 传输层接收消息数 */
+    uint64_t bytes_sent;             /* 发送字节数 */
+    uint64_t bytes_received;         /* 接收字节数 */
+    uint64_t connected_ms;           /* 当前连接已持续的时间（毫秒），未连接时为 0 */
+    uint64_t reliable_in_flight;     /* 可靠通道已发送未确认的消息数 */
+    uint64_t reliable_pending;       /* 可靠通道等待进入窗口的消息数 */
+    uint64_t reliable_retransmits;   /* 可靠通道重传次数 */
+    uint64_t log_dropped;            /* 异步日志丢弃数 */
+    uint64_t log_suppressed;         /* 采样/限速抑制的日志行数 */
+} ws_stats_t;
+
+/**
+ * @brief 延迟指标
+ */
+typedef enum {
+    WS_LATENCY_CONNECT_ATTEMPT = 0,  /* 单次握手耗时（成功的尝试） */
+    WS_LATENCY_CONNECT_TOTAL = 1,    /* 发起连接到连接建立的总耗时（含重连） */
+    WS_LATENCY_SEND = 2,             /* 已连接时从接受消息到写入传输层的耗时 */
+    WS_LATENCY_QUEUE_WAIT = 3,       /* 离线/积压队列中的等待时间 */
+    WS_LATENCY_PING_RTT = 4          /* Ping 往返时间 */
+} ws_latency_metric_t;
+
+/**
+ * @brief 延迟统计摘要（单位：纳秒）
+ */
+typedef struct {
+    uint64_t count;      /* 样本数 */
+    uint64_t min_ns;     /* 最小值 */
+    uint64_t max_ns;     /* 最大值 */
+    uint64_t mean_ns;    /* 平均值（估算） */
+    uint64_t p50_ns;     /* 50 分位 */
+    uint64_t p90_ns;     /* 90 分位 */
+    uint64_t p99_ns;     /* 99 分位 */
+    uint64_t p999_ns;    /* 99.9 分位 */
+} ws_latency_stats_t;
+
 /**
  * @brief WebSocket 句柄类型
  */
 typedef struct websocket_handle* websocket_handle_t;
 
+/**
+ * @brief 共享负载句柄类型（引用计数，可同时提交给多个连接）
+ */
+typedef struct ws_shared_payload* ws_shared_payload_t;
+
 /**
  * @brief 连接状态回调函数类型
  */
@@ -38,6 +167,13 @@ typedef void (*ws_message_callback_t)(websocket_handle_t handle, const char* mes
  */
 typedef void (*ws_error_callback_t)(websocket_handle_t handle, const char* error, void* user_data);
 
+/**
+ * @brief 发送完成回调函数类型
+ * @param success 1 表示消息已完整写入传输层，0 表示失败
+ * @param reason 失败原因（成功时为空字符串）
+ */
+typedef void (*ws_send_complete_callback_t)(websocket_handle_t handle, int success, const char* reason, void* user_data);
+
 /**
  * @brief 创建 WebSocket 句柄
  * @return WebSocket 句柄，失败返回 NULL
@@ -80,6 +216,15 @@ void ws_disconnect(websocket_handle_t handle);
  */
 int ws_send_text(websocket_handle_t handle, const char* message);
 
+/**
+ * @brief 发送带合并键的文本消息
+ * @param handle WebSocket 句柄
+ * @param key 合并键
+ * @param message 消息内容
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_send_keyed_text(websocket_handle_t handle, const char* key, const char* message);
+
 /**
  * @brief 发送二进制消息
  * @param handle WebSocket 句柄
@@ -89,6 +234,70 @@ int ws_send_text(websocket_handle_t handle, const char* message);
  */
 int ws_send_binary(websocket_handle_t handle, const uint8_t* data, size_t length);
 
+/**
+ * @brief 异步发送文本消息
+ * 
+ * 消息完整写入传输层或最终失败时调用 callback。参数无效时返回 -1 且不调用回调，
+ * 其余情况下回调恰好调用一次（可能在本函数返回前同步调用）。
+ * 
+ * @param handle WebSocket 句柄
+ * @param message 消息内容
+ * @param callback 完成回调
+ * @param user_data 传给回调的用户数据
+ * @return 0 表示消息已被接受（已发送或已加入队列），非 0 表示失败
+ */
+int ws_send_text_async(websocket_handle_t handle, const char* message,
+                       ws_send_complete_callback_t callback, void* user_data);
+
+/**
+ * @brief 异步发送二进制消息
+ * @param handle WebSocket 句柄
+ * @param data 二进制数据
+ * @param length 数据长度
+ * @param callback 完成回调，语义同 ws_send_text_async
+ * @param user_data 传给回调的用户数据
+ * @return 0 表示消息已被接受（已发送或已加入队列），非 0 表示失败
+ */
+int ws_send_binary_async(websocket_handle_t handle, const uint8_t* data, size_t length,
+                         ws_send_complete_callback_t callback, void* user_data);
+
+/**
+ * @brief 创建共享负载（复制一次数据）
+ * @param data 数据
+ * @param length 数据长度
+ * @return 共享负载句柄，失败返回 NULL
+ */
+ws_shared_payload_t ws_shared_payload_create(const void* data, size_t length);
+
+/**
+ * @brief 释放共享负载句柄
+ * 
+ * 已提交但尚未发送的消息仍持有各自的引用，释放句柄不影响它们。
+ * 
+ * @param payload 共享负载句柄
+ */
+void ws_shared_payload_release(ws_shared_payload_t payload);
+
+/**
+ * @brief 发送共享负载（不复制数据）
+ * @param handle WebSocket 句柄
+ * @param payload 共享负载句柄
+ * @param is_binary 非 0 按二进制消息发送，0 按文本消息发送
+ * @return 0 表示消息已被接受（已发送或已加入队列），非 0 表示失败
+ */
+int ws_send_shared(websocket_handle_t handle, ws_shared_payload_t payload, int is_binary);
+
+/**
+ * @brief 向多个连接广播同一共享负载
+ * @param handles WebSocket 句柄数组（NULL 元素会被跳过）
+ * @param count 句柄数量
+ * @param payload 共享负载句柄
+ * @param is_binary 非 0 按二进制消息发送，0 按文本消息发送
+ * @return 接受该消息的连接数，参数无效时返回 -1
+ */
+int ws_broadcast(const websocket_handle_t* handles, size_t count,
+                 ws_shared_payload_t payload, int is_binary);
+
 /**
  * @brief 发送 Ping 消息
  * @param handle WebSocket 句柄
@@ -142,6 +351,127 @@ void ws_set_error_callback(websocket_handle_t handle, ws_error_callback_t callba
  */
 void ws_enable_message_queue(websocket_handle_t handle, int enabled, size_t max_size);
 
+/**
+ * @brief 设置消息队列的字节上限和溢出策略
+ * @param handle WebSocket 句柄
+ * @param max_bytes 队列最大字节数
+ * @param policy 队列满时的处理策略
+ * @param block_timeout_ms WS_QUEUE_BLOCK 策略下的最长等待时间（毫秒）
+ */
+void ws_set_message_queue_limits(websocket_handle_t handle, size_t max_bytes,
+                                 ws_queue_overflow_policy_t policy, int block_timeout_ms);
+
+/**
+ * @brief 启用或禁用离线队列的按键合并
+ * @param handle WebSocket 句柄
+ * @param enabled 是否启用（1 表示是，0 表示否）
+ */
+void ws_enable_message_coalescing(websocket_handle_t handle, int enabled);
+
+/**
+ * @brief 设置指定优先级队列消息的存活时间，过期消息在出队时丢弃
+ * @param handle WebSocket 句柄
+ * @param priority 消息优先级
+ * @param ttl_ms 存活时间（毫秒），0 表示永不过期
+ */
+void ws_set_message_ttl(websocket_handle_t handle, ws_message_priority_t priority, uint64_t ttl_ms);
+
+/**
+ * @brief 设置重连后队列排空的速率，排空期间 URGENT 消息可插队直接发送
+ * @param handle WebSocket 句柄
+ * @param messages_per_second 每秒最多发送的积压消息数，0 表示不限速
+ * @param batch_size 每批最多发送的消息数
+ */
+void ws_set_queue_drain_rate(websocket_handle_t handle, double messages_per_second, size_t batch_size);
+
+/**
+ * @brief 设置连接级出站速率限制（各项为 0 表示不限制）
+ * @param handle WebSocket 句柄
+ * @param messages_per_second 每秒消息数
+ * @param message_burst 消息数突发容量（0 表示等于每秒消息数）
+ * @param bytes_per_second 每秒字节数
+ * @param byte_burst 字节数突发容量（0 表示等于每秒字节数）
+ */
+void ws_set_rate_limit(websocket_handle_t handle, double messages_per_second, double message_burst,
+                       double bytes_per_second, double byte_burst);
+
+/**
+ * @brief 设置指定优先级的出站速率限制，与连接级限制同时生效
+ * @param handle WebSocket 句柄
+ * @param priority 消息优先级
+ * @param messages_per_second 每秒消息数
+ * @param message_burst 消息数突发容量
+ * @param bytes_per_second 每秒字节数
+ * @param byte_burst 字节数突发容量
+ */
+void ws_set_priority_rate_limit(websocket_handle_t handle, ws_message_priority_t priority,
+                                double messages_per_second, double message_burst,
+                                double bytes_per_second, double byte_burst);
+
+/**
+ * @brief 设置超出速率时的处理方式
+ * @param handle WebSocket 句柄
+ * @param action 处理方式
+ */
+void ws_set_rate_limit_action(websocket_handle_t handle, ws_rate_limit_action_t action);
+
+/**
+ * @brief 获取因超出速率而被节流的发送次数
+ * @param handle WebSocket 句柄
+ * @return 节流次数
+ */
+uint64_t ws_get_throttled_count(websocket_handle_t handle);
+
+/**
+ * @brief 启用或禁用已连接时的加权公平发送调度（大消息按分片写入）
+ * @param handle WebSocket 句柄
+ * @param enabled 是否启用（1 表示是，0 表示否）
+ * @param fragment_size 分片大小（字节），0 表示不分片
+ */
+void ws_enable_fair_scheduling(websocket_handle_t handle, int enabled, size_t fragment_size);
+
+/**
+ * @brief 设置公平调度中指定优先级的权重
+ * @param handle WebSocket 句柄
+ * @param priority 消息优先级
+ * @param weight 权重
+ */
+void ws_set_priority_weight(websocket_handle_t handle, ws_message_priority_t priority, uint32_t weight);
+
+/**
+ * @brief 启用或禁用至少一次投递
+ * 
+ * 出站消息封装为 "@rd:<序号>:<负载>"，服务器以 "@ra:<序号>" 累积确认，
+ * 重连后重放未确认的消息。完成回调在收到确认时调用。
+ * 
+ * @param handle WebSocket 句柄
+ * @param enabled 是否启用（1 表示是，0 表示否）
+ * @param window_size 已发送未确认的最大消息数
+ * @param max_pending 等待进入窗口的最大消息数，0 表示不缓冲（窗口满或离线时拒绝）
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_enable_reliable_delivery(websocket_handle_t handle, int enabled,
+                                size_t window_size, size_t max_pending);
+
+/**
+ * @brief 获取消息缓冲池统计信息（进程级，所有句柄共享）
+ * @param stats 输出统计信息
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_get_buffer_pool_stats(ws_buffer_pool_stats_t* stats);
+
+/**
+ * @brief 启用持久化消息队列
+ * @param handle WebSocket 句柄
+ * @param directory 段文件目录
+ * @param segment_size 单个段文件大小（字节）
+ * @param max_segments 最大段文件数（0 表示不限制）
+ * @param sync_every 每追加多少条消息同步一次磁盘（0 表示交由操作系统回写）
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_enable_persistent_queue(websocket_handle_t handle, const char* directory,
+                               size_t segment_size, size_t max_segments, size_t sync_every);
+
 /**
  * @brief 启用心跳
  * @param handle WebSocket 句柄
@@ -150,6 +480,47 @@ void ws_enable_message_queue(websocket_handle_t handle, int enabled, size_t max_
  */
 void ws_enable_heartbeat(websocket_handle_t handle, int enabled, int interval_ms);
 
+/**
+ * @brief 设置本句柄所有模块的日志级别
+ * @param handle WebSocket 句柄
+ * @param level 日志级别
+ */
+void ws_set_log_level(websocket_handle_t handle, ws_log_level_t level);
+
+/**
+ * @brief 设置本句柄单个模块的日志级别（不影响其他句柄）
+ * @param handle WebSocket 句柄
+ * @param module 模块
+ * @param level 日志级别
+ */
+void ws_set_module_log_level(websocket_handle_t handle, ws_log_module_t module, ws_log_level_t level);
+
+/**
+ * @brief 启用或关闭异步日志（后台线程批量输出）
+ * @param handle WebSocket 句柄
+ * @param enabled 是否启用（1 表示是，0 表示否）
+ * @param capacity 队列容量（条）
+ * @param policy 队列满时的处理策略
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_enable_async_logging(websocket_handle_t handle, int enabled, size_t capacity,
+                            ws_log_overflow_policy_t policy);
+
+/**
+ * @brief 获取异步日志因队列满而丢弃的记录数
+ * @param handle WebSocket 句柄
+ * @return 丢弃数
+ */
+uint64_t ws_get_dropped_log_count(websocket_handle_t handle);
+
+/**
+ * @brief 启用或关闭二进制日志（格式化日志只写格式编号和参数，由 ws_log_decode 离线还原）
+ * @param handle WebSocket 句柄
+ * @param path 日志文件路径，为 NULL 时关闭二进制日志
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_enable_binary_logging(websocket_handle_t handle, const char* path);
+
 /**
  * @brief 获取统计信息
  * @param handle WebSocket 句柄
@@ -159,6 +530,55 @@ void ws_enable_heartbeat(websocket_handle_t handle, int enabled, int interval_ms
  */
 size_t ws_get_statistics(websocket_handle_t handle, char* buffer, size_t buffer_size);
 
+/**
+ * @brief 获取统计计数
+ * 
+ * 直接读取计数器填充结构体，不分配内存、不格式化文本，适合按秒轮询大量句柄。
+ * 
+ * @param handle WebSocket 句柄
+ * @param stats 输出统计计数
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_get_stats_struct(websocket_handle_t handle, ws_stats_t* stats);
+
+/**
+ * @brief 获取延迟指标的统计摘要
+ * @param handle WebSocket 句柄
+ * @param metric 延迟指标
+ * @param stats 输出统计摘要
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_get_latency_stats(websocket_handle_t handle, ws_latency_metric_t metric,
+                         ws_latency_stats_t* stats);
+
+/**
+ * @brief 合并多个句柄同一延迟指标的直方图后计算统计摘要
+ * @param handles 句柄数组（空句柄被跳过）
+ * @param count 句柄数
+ * @param metric 延迟指标
+ * @param stats 输出统计摘要
+ * @return 0 表示成功，非 0 表示失败
+ */
+int ws_get_merged_latency_stats(const websocket_handle_t* handles, size_t count,
+                                ws_latency_metric_t metric, ws_latency_stats_t* stats);
+
+/**
+ * @brief 清空句柄的所有延迟直方图
+ * @param handle WebSocket 句柄
+ */
+void ws_reset_latency_stats(websocket_handle_t handle);
+
+/**
+ * @brief 启用或禁用句柄的延迟记录
+ * 
+ * 默认启用。各指标的直方图在第一次记录时分配，全部用到时每个句柄约 40KB；
+ * 大量句柄只需汇总计数时可在连接前禁用。
+ * 
+ * @param handle WebSocket 句柄
+ * @param enabled 1 表示启用，0 表示禁用
+ */
+void ws_enable_latency_tracking(websocket_handle_t handle, int enabled);
+
 /**
  * @brief 设置配置
  * @param handle WebSocket 句柄
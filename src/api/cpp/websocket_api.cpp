@@ -1,4 +1,5 @@
 #include "websocket_api.h"
+#include <cstdlib>
 #include <memory>
 
 namespace cross_platform_websocket {
@@ -16,8 +17,11 @@ bool WebSocketAPI::initialize() {
         // 创建日志器
         logger_ = std::shared_ptr<Logger>(new Logger(platform_));
         
-        // 设置全局日志实例
-        g_logger = logger_;
+        // 本实例各层的日志写入自己的日志器；全局实例只供不属于任何实例的代码使用，
+        // 由第一个初始化的实例提供，之后创建的实例不再接管
+        if (!g_logger) {
+            g_logger = logger_;
+        }
         
         // 创建 WebSocket 管理器
         manager_ = std::unique_ptr<WebSocketManager>(new WebSocketManager(platform_, logger_));
@@ -67,18 +71,130 @@ bool WebSocketAPI::sendText(const std::string& message) {
         return false;
     }
     
-    LOG_DEBUG("API: 发送文本消息: " + message);
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送文本消息: " + message);
     return manager_->sendText(message);
 }
 
+bool WebSocketAPI::sendKeyedText(const std::string& key, const std::string& message) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        return false;
+    }
+    
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送带键文本消息 [" + key + "]: " + message);
+    return manager_->sendKeyedText(key, message);
+}
+
 bool WebSocketAPI::sendBinary(const std::vector<uint8_t>& data) {
+    return sendBinary(data.data(), data.size());
+}
+
+std::future<SendResult> WebSocketAPI::sendTextAsync(const std::string& message) {
+    auto promise = std::make_shared<std::promise<SendResult>>();
+    std::future<SendResult> future = promise->get_future();
+    
+    sendText(message, [promise](bool success, const std::string& reason) {
+        promise->set_value(SendResult(success, reason));
+    });
+    
+    return future;
+}
+
+std::future<SendResult> WebSocketAPI::sendBinaryAsync(const std::vector<uint8_t>& data) {
+    return sendBinaryAsync(data.data(), data.size());
+}
+
+std::future<SendResult> WebSocketAPI::sendBinaryAsync(const uint8_t* data, size_t length) {
+    auto promise = std::make_shared<std::promise<SendResult>>();
+    std::future<SendResult> future = promise->get_future();
+    
+    sendBinary(data, length, [promise](bool success, const std::string& reason) {
+        promise->set_value(SendResult(success, reason));
+    });
+    
+    return future;
+}
+
+bool WebSocketAPI::sendText(const std::string& message, SendCompletionCallback completion) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        if (completion) {
+            completion(false, "未初始化");
+        }
+        return false;
+    }
+    
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送文本消息: " + message);
+    return manager_->sendText(message, MessagePriority::NORMAL, completion);
+}
+
+bool WebSocketAPI::sendText(Payload&& message, SendCompletionCallback completion) {
     if (!manager_) {
         LOG_ERROR("WebSocket API 未初始化");
+        if (completion) {
+            completion(false, "未初始化");
+        }
         return false;
     }
     
-    LOG_DEBUG("API: 发送二进制消息，大小: " + std::to_string(data.size()) + " 字节");
-    return manager_->sendBinary(data);
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送文本消息，大小: " + std::to_string(message.size()) + " 字节");
+    return manager_->sendText(std::move(message), MessagePriority::NORMAL, completion);
+}
+
+bool WebSocketAPI::sendBinary(const std::vector<uint8_t>& data, SendCompletionCallback completion) {
+    return sendBinary(data.data(), data.size(), completion);
+}
+
+bool WebSocketAPI::sendBinary(const uint8_t* data, size_t length, SendCompletionCallback completion) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        if (completion) {
+            completion(false, "未初始化");
+        }
+        return false;
+    }
+    
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送二进制消息，大小: " + std::to_string(length) + " 字节");
+    return manager_->sendBinary(data, length, MessagePriority::NORMAL, completion);
+}
+
+bool WebSocketAPI::sendBinary(Payload&& data, SendCompletionCallback completion) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        if (completion) {
+            completion(false, "未初始化");
+        }
+        return false;
+    }
+    
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送二进制消息，大小: " + std::to_string(data.size()) + " 字节");
+    return manager_->sendBinary(std::move(data), MessagePriority::NORMAL, completion);
+}
+
+bool WebSocketAPI::sendShared(const SharedPayload& payload, bool binary,
+                              SendCompletionCallback completion) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        if (completion) {
+            completion(false, "未初始化");
+        }
+        return false;
+    }
+    
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 发送共享负载，大小: " + std::to_string(payload.size()) + " 字节");
+    return manager_->sendShared(payload, binary ? MessageType::BINARY : MessageType::TEXT,
+                                MessagePriority::NORMAL, completion);
+}
+
+size_t WebSocketAPI::broadcast(const std::vector<WebSocketAPI*>& targets,
+                               const SharedPayload& payload, bool binary) {
+    size_t accepted = 0;
+    for (WebSocketAPI* target : targets) {
+        if (target && target->sendShared(payload, binary)) {
+            accepted++;
+        }
+    }
+    return accepted;
 }
 
 bool WebSocketAPI::sendPing() {
@@ -117,6 +233,85 @@ void WebSocketAPI::enableMessageQueue(bool enabled, size_t max_size) {
     }
 }
 
+void WebSocketAPI::setMessageQueueLimits(size_t max_bytes, QueueOverflowPolicy policy,
+                                         int block_timeout_ms) {
+    if (manager_) {
+        manager_->setMessageQueueLimits(max_bytes, policy, block_timeout_ms);
+    }
+}
+
+void WebSocketAPI::enableMessageCoalescing(bool enabled) {
+    if (manager_) {
+        manager_->enableMessageCoalescing(enabled);
+    }
+}
+
+void WebSocketAPI::setMessageTTL(MessagePriority priority, uint64_t ttl_ms) {
+    if (manager_) {
+        manager_->setMessageTTL(priority, ttl_ms);
+    }
+}
+
+void WebSocketAPI::setQueueDrainRate(double messages_per_second, size_t batch_size) {
+    if (manager_) {
+        manager_->setQueueDrainRate(messages_per_second, batch_size);
+    }
+}
+
+void WebSocketAPI::setRateLimit(const RateLimitOptions& options) {
+    if (manager_) {
+        manager_->setRateLimit(options);
+    }
+}
+
+void WebSocketAPI::setPriorityRateLimit(MessagePriority priority, const RateLimitOptions& options) {
+    if (manager_) {
+        manager_->setPriorityRateLimit(priority, options);
+    }
+}
+
+void WebSocketAPI::setRateLimitAction(RateLimitAction action) {
+    if (manager_) {
+        manager_->setRateLimitAction(action);
+    }
+}
+
+uint64_t WebSocketAPI::getThrottledMessageCount() const {
+    return manager_ ? manager_->getThrottledMessageCount() : 0;
+}
+
+void WebSocketAPI::enableFairScheduling(bool enabled, size_t fragment_size) {
+    if (manager_) {
+        manager_->enableFairScheduling(enabled, fragment_size);
+    }
+}
+
+void WebSocketAPI::setPriorityWeight(MessagePriority priority, uint32_t weight) {
+    if (manager_) {
+        manager_->setPriorityWeight(priority, weight);
+    }
+}
+
+bool WebSocketAPI::enableReliableDelivery(bool enabled, const ReliableChannelOptions& options) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        return false;
+    }
+    return manager_->enableReliableDelivery(enabled, options);
+}
+
+BufferPoolStats WebSocketAPI::getBufferPoolStats() const {
+    return BufferPool::instance().getStats();
+}
+
+bool WebSocketAPI::enablePersistentQueue(const SegmentLogOptions& options) {
+    if (!manager_) {
+        LOG_ERROR("WebSocket API 未初始化");
+        return false;
+    }
+    return manager_->enablePersistentQueue(options);
+}
+
 void WebSocketAPI::enableHeartbeat(bool enabled, int interval_ms) {
     if (manager_) {
         if (enabled) {
@@ -133,16 +328,139 @@ std::string WebSocketAPI::getStatistics() const {
     return "WebSocket API 未初始化";
 }
 
+WebSocketStats WebSocketAPI::getStats() const {
+    return manager_ ? manager_->getStats() : WebSocketStats();
+}
+
+LatencyStats WebSocketAPI::getLatencyStats(LatencyMetric metric) const {
+    return getLatencySnapshot(metric).stats();
+}
+
+LatencySnapshot WebSocketAPI::getLatencySnapshot(LatencyMetric metric) const {
+    return manager_ ? manager_->getLatencySnapshot(metric) : LatencySnapshot();
+}
+
+void WebSocketAPI::resetLatencyStats() {
+    if (manager_) {
+        manager_->resetLatencyHistograms();
+    }
+}
+
+void WebSocketAPI::enableLatencyTracking(bool enabled) {
+    if (manager_) {
+        manager_->enableLatencyTracking(enabled);
+    }
+}
+
 void WebSocketAPI::setLogLevel(LogLevel level) {
     if (logger_) {
         logger_->setLogLevel(level);
     }
 }
 
+void WebSocketAPI::setModuleLogLevel(LogModule module, LogLevel level) {
+    if (logger_) {
+        logger_->setModuleLevel(module, level);
+    }
+}
+
+std::shared_ptr<Logger> WebSocketAPI::getLogger() const {
+    return logger_;
+}
+
+bool WebSocketAPI::enableAsyncLogging(bool enabled, size_t capacity, LogOverflowPolicy policy) {
+    if (!logger_) {
+        return false;
+    }
+    
+    LOG_INFO(std::string(enabled ? "启用" : "关闭") + "异步日志");
+    return logger_->enableAsync(enabled, capacity, policy);
+}
+
+uint64_t WebSocketAPI::getDroppedLogCount() const {
+    return logger_ ? logger_->getDroppedCount() : 0;
+}
+
+bool WebSocketAPI::enableBinaryLogging(const std::string& path) {
+    if (!logger_) {
+        return false;
+    }
+    
+    if (!logger_->enableBinaryLog(path)) {
+        LOG_ERROR("无法打开二进制日志文件: " + path);
+        return false;
+    }
+    LOG_INFO("启用二进制日志: " + path);
+    return true;
+}
+
+void WebSocketAPI::disableBinaryLogging() {
+    if (logger_) {
+        logger_->disableBinaryLog();
+    }
+}
+
 void WebSocketAPI::setConfig(const std::string& key, const std::string& value) {
     if (manager_) {
         manager_->setConfig(key, value);
+        if (key.compare(0, 4, "log_") == 0) {
+            applyLogConfig();
+        }
+    }
+}
+
+void WebSocketAPI::applyLogConfig() {
+    if (!logger_) {
+        return;
+    }
+    
+    auto number = [this](const std::string& key, size_t fallback) {
+        std::string text = manager_->getConfig(key);
+        if (text.empty()) {
+            return fallback;
+        }
+        char* end = nullptr;
+        unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+        return (end && *end == '\0') ? static_cast<size_t>(value) : fallback;
+    };
+    
+    std::string console = manager_->getConfig("log_console");
+    logger_->setConsoleOutput(console != "0" && console != "false");
+    
+    MappedFileLogSinkOptions options;
+    options.directory = manager_->getConfig("log_file_dir");
+    if (options.directory.empty()) {
+        if (file_log_sink_) {
+            logger_->flush();
+            logger_->removeSink(file_log_sink_);
+            file_log_sink_->close();
+            file_log_sink_.reset();
+            LOG_INFO("关闭日志文件");
+        }
+        return;
+    }
+    
+    std::string prefix = manager_->getConfig("log_file_prefix");
+    if (!prefix.empty()) {
+        options.prefix = prefix;
+    }
+    options.segment_size = number("log_file_segment_size", options.segment_size);
+    options.max_segments = number("log_file_max_segments", options.max_segments);
+    
+    // 已打开时切换到按新配置创建的段，输出目标本身保持注册
+    std::shared_ptr<MappedFileLogSink> sink = file_log_sink_;
+    if (!sink) {
+        sink = std::make_shared<MappedFileLogSink>();
+    }
+    if (!sink->open(options)) {
+        LOG_ERROR("无法打开日志文件，目录: " + options.directory);
+        return;
+    }
+    if (!file_log_sink_) {
+        file_log_sink_ = sink;
+        logger_->addSink(sink);
     }
+    LOG_INFO("日志写入文件: " + sink->currentPath());
 }
 
 std::string WebSocketAPI::getConfig(const std::string& key) const {
@@ -158,10 +476,10 @@ void WebSocketAPI::onConnectionStateChanged(ConnectionState state) {
 }
 
 void WebSocketAPI::onMessageReceived(const WebSocketMessage& message) {
-    LOG_DEBUG("API: 接收消息: " + message.data);
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "API: 接收消息: " + message.data.str());
     
     if (user_message_callback_) {
-        user_message_callback_(message.data);
+        user_message_callback_(message.data.str());
     }
 }
 
@@ -2,13 +2,26 @@
 
 #include "../../business/websocket_manager.h"
 #include "../../core/logger/logger.h"
+#include "../../core/logger/mapped_file_sink.h"
 #include "../../platform/platform_interface.h"
 #include <string>
 #include <memory>
 #include <functional>
+#include <future>
 
 namespace cross_platform_websocket {
 
+/**
+ * @brief 异步发送结果
+ */
+struct SendResult {
+    bool success;       // 消息是否已完整写入传输层
+    std::string error;  // 失败原因（成功时为空）
+    
+    SendResult() : success(false) {}
+    SendResult(bool s, const std::string& e) : success(s), error(e) {}
+};
+
 /**
  * @brief WebSocket API 类
  * 
@@ -53,6 +66,17 @@ public:
      */
     bool sendText(const std::string& message);
     
+    /**
+     * @brief 发送带合并键的文本消息
+     * 
+     * 启用按键合并后，离线队列中同键消息只保留最新一条（保留原有队列位置）。
+     * 
+     * @param key 合并键
+     * @param message 消息内容
+     * @return 消息是否被接受
+     */
+    bool sendKeyedText(const std::string& key, const std::string& message);
+    
     /**
      * @brief 发送二进制消息
      * @param data 二进制数据
@@ -60,6 +84,97 @@ public:
      */
     bool sendBinary(const std::vector<uint8_t>& data);
     
+    /**
+     * @brief 异步发送文本消息
+     * 
+     * 返回的 future 在消息完整写入传输层时就绪；若消息在离线队列中，
+     * 则在重连后写出时就绪。发送失败、被丢弃或队列被清空时以失败结果就绪。
+     * 
+     * @param message 消息内容
+     * @return 发送结果
+     */
+    std::future<SendResult> sendTextAsync(const std::string& message);
+    
+    /**
+     * @brief 异步发送二进制消息
+     * @param data 二进制数据
+     * @return 发送结果，语义同 sendTextAsync
+     */
+    std::future<SendResult> sendBinaryAsync(const std::vector<uint8_t>& data);
+    
+    /**
+     * @brief 异步发送一段连续内存中的二进制消息
+     * @param data 二进制数据指针
+     * @param length 字节数
+     * @return 发送结果，语义同 sendTextAsync
+     */
+    std::future<SendResult> sendBinaryAsync(const uint8_t* data, size_t length);
+    
+    /**
+     * @brief 发送文本消息，并在写入完成时回调
+     * @param message 消息内容
+     * @param completion 完成回调，恰好调用一次
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendText(const std::string& message, SendCompletionCallback completion);
+    
+    /**
+     * @brief 发送文本消息并转移负载所有权（整个发送过程不复制负载）
+     * @param message 消息内容（调用后为空）
+     * @param completion 完成回调，恰好调用一次
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendText(Payload&& message, SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 发送二进制消息，并在写入完成时回调
+     * @param data 二进制数据
+     * @param completion 完成回调，恰好调用一次
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendBinary(const std::vector<uint8_t>& data, SendCompletionCallback completion);
+    
+    /**
+     * @brief 发送一段连续内存中的二进制消息（直接发送时不复制）
+     * @param data 二进制数据指针
+     * @param length 字节数
+     * @param completion 完成回调，恰好调用一次
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendBinary(const uint8_t* data, size_t length,
+                    SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 发送二进制消息并转移负载所有权（整个发送过程不复制负载）
+     * @param data 二进制数据（调用后为空）
+     * @param completion 完成回调，恰好调用一次
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendBinary(Payload&& data, SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 发送共享负载（不复制数据）
+     * @param payload 共享负载
+     * @param binary 是否按二进制消息发送
+     * @param completion 完成回调，恰好调用一次
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendShared(const SharedPayload& payload, bool binary,
+                    SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 向多个连接广播同一负载
+     * 
+     * 负载只存储一份，各连接只持有引用，组帧和掩码在各自写入时完成。
+     * 
+     * @param targets 目标连接（空指针会被跳过）
+     * @param payload 共享负载
+     * @param binary 是否按二进制消息发送
+     * @return 接受该消息的连接数
+     */
+    static size_t broadcast(const std::vector<WebSocketAPI*>& targets,
+                            const SharedPayload& payload, bool binary);
+    
     /**
      * @brief 发送 Ping 消息
      * @return 是否发送成功
@@ -103,6 +218,97 @@ public:
      */
     void enableMessageQueue(bool enabled, size_t max_size = 1000);
     
+    /**
+     * @brief 设置消息队列的字节上限和溢出策略
+     * @param max_bytes 队列最大字节数
+     * @param policy 队列满时的处理策略
+     * @param block_timeout_ms BLOCK 策略下的最长等待时间（毫秒）
+     */
+    void setMessageQueueLimits(size_t max_bytes,
+                               QueueOverflowPolicy policy = QueueOverflowPolicy::REJECT_NEWEST,
+                               int block_timeout_ms = 0);
+    
+    /**
+     * @brief 启用或禁用离线队列的按键合并
+     * @param enabled 是否启用
+     */
+    void enableMessageCoalescing(bool enabled);
+    
+    /**
+     * @brief 设置指定优先级队列消息的存活时间，过期消息在出队时丢弃
+     * @param priority 消息优先级
+     * @param ttl_ms 存活时间（毫秒），0 表示永不过期
+     */
+    void setMessageTTL(MessagePriority priority, uint64_t ttl_ms);
+    
+    /**
+     * @brief 设置重连后队列排空的速率，排空期间 URGENT 消息可插队直接发送
+     * @param messages_per_second 每秒最多发送的积压消息数，0 表示不限速
+     * @param batch_size 每批最多发送的消息数
+     */
+    void setQueueDrainRate(double messages_per_second, size_t batch_size = 64);
+    
+    /**
+     * @brief 设置连接级出站速率限制
+     * @param options 速率限制配置（消息数/秒、字节数/秒及突发容量）
+     */
+    void setRateLimit(const RateLimitOptions& options);
+    
+    /**
+     * @brief 设置指定优先级的出站速率限制
+     * @param priority 消息优先级
+     * @param options 速率限制配置
+     */
+    void setPriorityRateLimit(MessagePriority priority, const RateLimitOptions& options);
+    
+    /**
+     * @brief 设置超出速率时的处理方式
+     * @param action 加入队列补发或直接拒绝
+     */
+    void setRateLimitAction(RateLimitAction action);
+    
+    /**
+     * @brief 获取因超出速率而被节流的发送次数
+     * @return 节流次数
+     */
+    uint64_t getThrottledMessageCount() const;
+    
+    /**
+     * @brief 启用或禁用已连接时的加权公平发送调度（大消息按分片写入）
+     * @param enabled 是否启用
+     * @param fragment_size 分片大小（字节），0 表示不分片
+     */
+    void enableFairScheduling(bool enabled, size_t fragment_size = 16 * 1024);
+    
+    /**
+     * @brief 设置公平调度中指定优先级的权重
+     * @param priority 消息优先级
+     * @param weight 权重
+     */
+    void setPriorityWeight(MessagePriority priority, uint32_t weight);
+    
+    /**
+     * @brief 启用或禁用至少一次投递（序号、累积确认、重连后重放未确认消息）
+     * @param enabled 是否启用
+     * @param options 窗口配置
+     * @return 是否成功
+     */
+    bool enableReliableDelivery(bool enabled,
+                                const ReliableChannelOptions& options = ReliableChannelOptions());
+    
+    /**
+     * @brief 获取消息缓冲池统计信息（进程级）
+     * @return 统计信息
+     */
+    BufferPoolStats getBufferPoolStats() const;
+    
+    /**
+     * @brief 启用持久化消息队列，进程重启后回放未发送的消息
+     * @param options 段日志配置
+     * @return 是否成功
+     */
+    bool enablePersistentQueue(const SegmentLogOptions& options);
+    
     /**
      * @brief 启用心跳
      * @param enabled 是否启用
@@ -117,13 +323,93 @@ public:
     std::string getStatistics() const;
     
     /**
-     * @brief 设置日志级别
+     * @brief 获取统计计数（不分配内存、不构造字符串，适合高频轮询）
+     * @return 统计信息（未初始化时全为 0）
+     */
+    WebSocketStats getStats() const;
+    
+    /**
+     * @brief 获取延迟指标的统计摘要（p50/p90/p99/p999 等，单位纳秒）
+     * @param metric 延迟指标
+     * @return 统计摘要（未初始化或无样本时全为 0）
+     */
+    LatencyStats getLatencyStats(LatencyMetric metric) const;
+    
+    /**
+     * @brief 获取延迟指标的直方图副本，用于与其他连接合并后计算分位数
+     * @param metric 延迟指标
+     * @return 副本
+     */
+    LatencySnapshot getLatencySnapshot(LatencyMetric metric) const;
+    
+    /**
+     * @brief 清空所有延迟直方图
+     */
+    void resetLatencyStats();
+    
+    /**
+     * @brief 启用或禁用延迟记录（默认启用，全部指标都有样本时每个连接约 40KB）
+     * @param enabled 是否启用
+     */
+    void enableLatencyTracking(bool enabled);
+    
+    /**
+     * @brief 设置本实例所有模块的日志级别
      * @param level 日志级别
      */
     void setLogLevel(LogLevel level);
     
+    /**
+     * @brief 设置本实例单个模块的日志级别（不影响其他实例）
+     * @param module 模块
+     * @param level 日志级别（OFF 表示关闭）
+     */
+    void setModuleLogLevel(LogModule module, LogLevel level);
+    
+    /**
+     * @brief 获取本实例的日志器
+     * @return 日志器（未初始化时为空）
+     */
+    std::shared_ptr<Logger> getLogger() const;
+    
+    /**
+     * @brief 启用或关闭异步日志
+     * @param enabled 是否启用
+     * @param capacity 队列容量（条）
+     * @param policy 队列满时的处理策略
+     * @return 是否成功
+     */
+    bool enableAsyncLogging(bool enabled, size_t capacity = 8192,
+                            LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+    
+    /**
+     * @brief 获取异步日志因队列满而丢弃的记录数
+     * @return 丢弃数
+     */
+    uint64_t getDroppedLogCount() const;
+    
+    /**
+     * @brief 启用二进制日志（格式化日志由 ws_log_decode 工具离线还原）
+     * @param path 日志文件路径
+     * @return 是否成功
+     */
+    bool enableBinaryLogging(const std::string& path);
+    
+    /**
+     * @brief 关闭二进制日志
+     */
+    void disableBinaryLogging();
+    
     /**
      * @brief 设置配置
+     * 
+     * 以下日志相关的键在保存后立即生效：
+     *   log_file_dir           日志目录，非空时写入内存映射的分段日志文件，为空时关闭
+     *   log_file_prefix        日志文件名前缀（默认 websocket）
+     *   log_file_segment_size  单个段文件大小（字节，默认 16 MB）
+     *   log_file_max_segments  最多保留的段文件数（默认 8，0 表示不删除）
+     *   log_console            是否同时输出到控制台（1/0，默认 1）
+     * 
      * @param key 配置键
      * @param value 配置值
      */
@@ -137,9 +423,22 @@ public:
     std::string getConfig(const std::string& key) const;
 
 private:
+    /**
+     * @brief 日志宏使用的上下文：写入本实例的日志器，按 API 模块的级别过滤
+     */
+    LogContext wsLogContext(LogContextTag) const {
+        return LogContext(logger_.get(), LogModule::API);
+    }
+    
     std::shared_ptr<PlatformInterface> platform_;
     std::shared_ptr<Logger> logger_;
     std::unique_ptr<WebSocketManager> manager_;
+    std::shared_ptr<MappedFileLogSink> file_log_sink_;
+    
+    /**
+     * @brief 按 log_* 配置打开、重新打开或关闭日志文件
+     */
+    void applyLogConfig();
     
     // 内部回调处理
     void onConnectionStateChanged(ConnectionState state);
@@ -0,0 +1,127 @@
+#include "fair_scheduler.h"
+
+namespace cross_platform_websocket {
+
+const size_t FairScheduler::kPriorityLevels;
+
+// 默认权重：LOW 1、NORMAL 2、HIGH 4、URGENT 8
+static const uint32_t kDefaultWeights[FairScheduler::kPriorityLevels] = { 1, 2, 4, 8 };
+
+// 默认每单位权重每轮 16KB
+static const size_t kDefaultQuantum = 16 * 1024;
+
+FairScheduler::FairScheduler()
+    : current_(kPriorityLevels - 1)
+    , quantum_(kDefaultQuantum)
+    , size_(0)
+    , bytes_(0)
+    , active_lanes_(0) {
+    for (size_t i = 0; i < kPriorityLevels; ++i) {
+        lanes_[i].weight = kDefaultWeights[i];
+    }
+}
+
+void FairScheduler::setWeight(MessagePriority priority, uint32_t weight) {
+    size_t lane = static_cast<size_t>(priority);
+    if (lane < kPriorityLevels) {
+        lanes_[lane].weight = weight > 0 ? weight : 1;
+    }
+}
+
+uint32_t FairScheduler::getWeight(MessagePriority priority) const {
+    size_t lane = static_cast<size_t>(priority);
+    return lane < kPriorityLevels ? lanes_[lane].weight : 0;
+}
+
+void FairScheduler::setQuantum(size_t bytes) {
+    quantum_ = bytes > 0 ? bytes : 1;
+}
+
+void FairScheduler::push(QueuedMessage&& message) {
+    size_t lane = static_cast<size_t>(message.priority);
+    if (lane >= kPriorityLevels) {
+        lane = static_cast<size_t>(MessagePriority::NORMAL);
+    }
+    
+    if (lanes_[lane].messages.empty()) {
+        active_lanes_++;
+    }
+    bytes_ += message.data.size();
+    size_++;
+    lanes_[lane].messages.push(std::move(message));
+}
+
+bool FairScheduler::pop(QueuedMessage& out) {
+    if (size_ == 0) {
+        return false;
+    }
+    
+    while (true) {
+        Lane& lane = lanes_[current_];
+        
+        if (lane.messages.empty()) {
+            advance();
+            continue;
+        }
+        
+        // 只有一条非空队列时无需轮转，直接出队
+        if (active_lanes_ == 1) {
+            lane.deficit = 0;
+            lane.credited = false;
+            take(lane, out);
+            return true;
+        }
+        
+        if (!lane.credited) {
+            lane.deficit += static_cast<uint64_t>(quantum_) * lane.weight;
+            lane.credited = true;
+        }
+        
+        size_t cost = lane.messages.front().data.size();
+        if (cost <= lane.deficit) {
+            lane.deficit -= cost;
+            take(lane, out);
+            return true;
+        }
+        
+        // 额度不足，留到下一轮继续累积
+        advance();
+    }
+}
+
+void FairScheduler::drainAll(std::vector<QueuedMessage>& out) {
+    for (size_t i = kPriorityLevels; i-- > 0;) {
+        Lane& lane = lanes_[i];
+        QueuedMessage message;
+        while (lane.messages.pop(message)) {
+            out.push_back(std::move(message));
+        }
+        lane.deficit = 0;
+        lane.credited = false;
+    }
+    size_ = 0;
+    bytes_ = 0;
+    active_lanes_ = 0;
+    current_ = kPriorityLevels - 1;
+}
+
+void FairScheduler::advance() {
+    lanes_[current_].credited = false;
+    current_ = current_ == 0 ? kPriorityLevels - 1 : current_ - 1;
+}
+
+void FairScheduler::take(Lane& lane, QueuedMessage& out) {
+    lane.messages.pop(out);
+    size_--;
+    bytes_ -= out.data.size();
+    
+    // 队列取空后清零额度，避免空闲期间积攒额度
+    if (lane.messages.empty()) {
+        lane.deficit = 0;
+        lane.credited = false;
+        active_lanes_--;
+        advance();
+    }
+}
+
+} // namespace cross_platform_websocket
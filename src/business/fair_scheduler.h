@@ -0,0 +1,107 @@
+#pragma once
+
+#include "message_queue.h"
+#include <cstdint>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 按权重在各优先级之间公平调度的发送队列
+ * 
+ * 采用赤字轮转（Deficit Round Robin）：每轮访问非空优先级队列时为其累加
+ * quantum × weight 字节的额度，队首消息不超过额度时出队并扣减。
+ * 各优先级按权重分配发送字节数，大消息不会长期挤占高优先级消息。
+ * 
+ * 本类不做同步，由 WebSocketManager 在 scheduler_mutex_ 下访问。
+ */
+class FairScheduler {
+public:
+    /**
+     * @brief 优先级级别数
+     */
+    static const size_t kPriorityLevels = MessageQueue::kPriorityLevels;
+    
+    FairScheduler();
+    
+    /**
+     * @brief 设置指定优先级的权重
+     * @param priority 消息优先级
+     * @param weight 权重（至少为 1）
+     */
+    void setWeight(MessagePriority priority, uint32_t weight);
+    
+    /**
+     * @brief 获取指定优先级的权重
+     * @param priority 消息优先级
+     * @return 权重
+     */
+    uint32_t getWeight(MessagePriority priority) const;
+    
+    /**
+     * @brief 设置每轮每单位权重的字节额度
+     * @param bytes 字节额度（至少为 1）
+     */
+    void setQuantum(size_t bytes);
+    
+    /**
+     * @brief 将消息移入对应优先级队列的队尾
+     * @param message 消息
+     */
+    void push(QueuedMessage&& message);
+    
+    /**
+     * @brief 按赤字轮转弹出下一条待发送消息
+     * @param out 输出消息
+     * @return 队列为空时返回 false
+     */
+    bool pop(QueuedMessage& out);
+    
+    /**
+     * @brief 弹出全部消息（按优先级从高到低），并重置各队列额度
+     * @param out 输出消息
+     */
+    void drainAll(std::vector<QueuedMessage>& out);
+    
+    /**
+     * @brief 获取消息总数
+     * @return 消息数量
+     */
+    size_t size() const { return size_; }
+    
+    /**
+     * @brief 检查是否为空
+     * @return 是否为空
+     */
+    bool empty() const { return size_ == 0; }
+    
+    /**
+     * @brief 获取消息负载的总字节数
+     * @return 字节数
+     */
+    size_t bytes() const { return bytes_; }
+
+private:
+    /**
+     * @brief 单个优先级的队列和调度状态
+     */
+    struct Lane {
+        RingBuffer<QueuedMessage> messages;
+        uint32_t weight;
+        uint64_t deficit;   // 剩余额度（字节）
+        bool credited;      // 本轮是否已累加额度
+        
+        Lane() : weight(1), deficit(0), credited(false) {}
+    };
+    
+    Lane lanes_[kPriorityLevels];
+    size_t current_;      // 当前轮转到的优先级队列（从 URGENT 开始）
+    size_t quantum_;
+    size_t size_;
+    size_t bytes_;
+    size_t active_lanes_; // 非空优先级队列数
+    
+    void advance();
+    void take(Lane& lane, QueuedMessage& out);
+};
+
+} // namespace cross_platform_websocket
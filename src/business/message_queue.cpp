@@ -0,0 +1,298 @@
+#include "message_queue.h"
+
+namespace cross_platform_websocket {
+
+const size_t MessageQueue::kPriorityLevels;
+
+// 索引装载因子上限为 1/2，保证线性探测的查找长度较短
+static const size_t kMinIndexCapacity = 64;
+
+MessageQueue::MessageQueue()
+    : size_(0)
+    , bytes_(0)
+    , coalescing_(false)
+    , index_count_(0) {
+    for (size_t i = 0; i < kPriorityLevels; ++i) {
+        lane_bytes_[i] = 0;
+    }
+}
+
+void MessageQueue::reserve(size_t capacity) {
+    for (size_t i = 0; i < kPriorityLevels; ++i) {
+        lanes_[i].reserve(capacity);
+    }
+}
+
+void MessageQueue::setCoalescing(bool enabled) {
+    coalescing_ = enabled;
+    if (enabled) {
+        rebuildIndex(kMinIndexCapacity);
+    } else {
+        index_.clear();
+        index_count_ = 0;
+    }
+}
+
+QueuedMessage* MessageQueue::find(const std::string& key) {
+    if (!coalescing_ || key.empty()) {
+        return nullptr;
+    }
+    size_t slot = findSlot(key, std::hash<std::string>()(key));
+    if (slot == index_.size()) {
+        return nullptr;
+    }
+    return &lanes_[index_[slot].lane].at(index_[slot].position);
+}
+
+bool MessageQueue::push(QueuedMessage&& message, QueuedMessage* superseded) {
+    size_t hash = 0;
+    if (coalescing_ && !message.key.empty()) {
+        hash = std::hash<std::string>()(message.key);
+        size_t slot = findSlot(message.key, hash);
+        if (slot != index_.size()) {
+            // 原地替换同键消息，保留其队列位置和所属优先级
+            size_t lane = index_[slot].lane;
+            QueuedMessage& existing = lanes_[lane].at(index_[slot].position);
+            size_t old_bytes = existing.data.size();
+            size_t new_bytes = message.data.size();
+            
+            message.priority = existing.priority;
+            if (superseded) {
+                *superseded = std::move(existing);
+            }
+            existing = std::move(message);
+            
+            lane_bytes_[lane] = lane_bytes_[lane] - old_bytes + new_bytes;
+            bytes_ = bytes_ - old_bytes + new_bytes;
+            return true;
+        }
+    }
+    
+    size_t lane = laneIndex(message.priority);
+    size_t bytes = message.data.size();
+    bool keyed = coalescing_ && !message.key.empty();
+    uint64_t position = lanes_[lane].tail();
+    
+    if (keyed && (index_count_ + 1) * 2 > index_.size()) {
+        rebuildIndex(index_.empty() ? kMinIndexCapacity : index_.size() * 2);
+    }
+    
+    lanes_[lane].push(std::move(message));
+    lane_bytes_[lane] += bytes;
+    bytes_ += bytes;
+    size_++;
+    
+    if (keyed) {
+        indexInsert(hash, static_cast<uint8_t>(lane), position);
+    }
+    return false;
+}
+
+bool MessageQueue::pushFront(QueuedMessage& message) {
+    size_t lane = laneIndex(message.priority);
+    bool keyed = coalescing_ && !message.key.empty();
+    size_t hash = 0;
+    if (keyed) {
+        hash = std::hash<std::string>()(message.key);
+        if (findSlot(message.key, hash) != index_.size()) {
+            return false;
+        }
+        if ((index_count_ + 1) * 2 > index_.size()) {
+            rebuildIndex(index_.empty() ? kMinIndexCapacity : index_.size() * 2);
+        }
+    }
+    
+    size_t bytes = message.data.size();
+    lanes_[lane].pushFront(std::move(message));
+    lane_bytes_[lane] += bytes;
+    bytes_ += bytes;
+    size_++;
+    
+    if (keyed) {
+        indexInsert(hash, static_cast<uint8_t>(lane), lanes_[lane].head());
+    }
+    return true;
+}
+
+QueuedMessage* MessageQueue::front() {
+    RingBuffer<QueuedMessage>* lane = topLane();
+    return lane ? &lane->front() : nullptr;
+}
+
+bool MessageQueue::pop(QueuedMessage& out) {
+    RingBuffer<QueuedMessage>* lane = topLane();
+    if (!lane) {
+        return false;
+    }
+    popFrom(static_cast<size_t>(lane - lanes_), out);
+    return true;
+}
+
+void MessageQueue::pop() {
+    QueuedMessage discarded;
+    pop(discarded);
+}
+
+bool MessageQueue::evictOldest(MessagePriority max_priority, QueuedMessage& out) {
+    size_t max_lane = laneIndex(max_priority);
+    for (size_t i = 0; i <= max_lane; ++i) {
+        if (!lanes_[i].empty()) {
+            popFrom(i, out);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MessageQueue::clear() {
+    for (size_t i = 0; i < kPriorityLevels; ++i) {
+        lanes_[i].clear();
+        lane_bytes_[i] = 0;
+    }
+    size_ = 0;
+    bytes_ = 0;
+    
+    for (auto& entry : index_) {
+        entry.used = false;
+    }
+    index_count_ = 0;
+}
+
+size_t MessageQueue::size() const {
+    return size_;
+}
+
+bool MessageQueue::empty() const {
+    return size_ == 0;
+}
+
+size_t MessageQueue::bytes() const {
+    return bytes_;
+}
+
+size_t MessageQueue::sizeAtOrBelow(MessagePriority max_priority) const {
+    size_t count = 0;
+    for (size_t i = 0; i <= laneIndex(max_priority); ++i) {
+        count += lanes_[i].size();
+    }
+    return count;
+}
+
+size_t MessageQueue::bytesAtOrBelow(MessagePriority max_priority) const {
+    size_t bytes = 0;
+    for (size_t i = 0; i <= laneIndex(max_priority); ++i) {
+        bytes += lane_bytes_[i];
+    }
+    return bytes;
+}
+
+size_t MessageQueue::laneIndex(MessagePriority priority) {
+    size_t lane = static_cast<size_t>(priority);
+    return lane < kPriorityLevels ? lane : static_cast<size_t>(MessagePriority::NORMAL);
+}
+
+RingBuffer<QueuedMessage>* MessageQueue::topLane() {
+    for (size_t i = kPriorityLevels; i > 0; --i) {
+        if (!lanes_[i - 1].empty()) {
+            return &lanes_[i - 1];
+        }
+    }
+    return nullptr;
+}
+
+void MessageQueue::popFrom(size_t lane, QueuedMessage& out) {
+    if (coalescing_ && !lanes_[lane].front().key.empty()) {
+        indexErase(lanes_[lane].front().key, static_cast<uint8_t>(lane), lanes_[lane].head());
+    }
+    lanes_[lane].pop(out);
+    lane_bytes_[lane] -= out.data.size();
+    bytes_ -= out.data.size();
+    size_--;
+}
+
+size_t MessageQueue::findSlot(const std::string& key, size_t hash) {
+    if (index_.empty()) {
+        return index_.size();
+    }
+    
+    size_t mask = index_.size() - 1;
+    for (size_t i = hash & mask; index_[i].used; i = (i + 1) & mask) {
+        const IndexEntry& entry = index_[i];
+        if (entry.hash == hash && lanes_[entry.lane].at(entry.position).key == key) {
+            return i;
+        }
+    }
+    return index_.size();
+}
+
+void MessageQueue::indexInsert(size_t hash, uint8_t lane, uint64_t position) {
+    size_t mask = index_.size() - 1;
+    size_t i = hash & mask;
+    while (index_[i].used) {
+        i = (i + 1) & mask;
+    }
+    
+    index_[i].hash = hash;
+    index_[i].position = position;
+    index_[i].lane = lane;
+    index_[i].used = true;
+    index_count_++;
+}
+
+void MessageQueue::indexErase(const std::string& key, uint8_t lane, uint64_t position) {
+    if (index_.empty()) {
+        return;
+    }
+    
+    size_t mask = index_.size() - 1;
+    size_t i = std::hash<std::string>()(key) & mask;
+    while (index_[i].used && !(index_[i].lane == lane && index_[i].position == position)) {
+        i = (i + 1) & mask;
+    }
+    if (!index_[i].used) {
+        return;
+    }
+    
+    // 向后移位删除：把探测链上后续可前移的项移入空位，保持查找正确
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (!index_[j].used) {
+            break;
+        }
+        size_t home = index_[j].hash & mask;
+        bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            index_[i] = index_[j];
+            i = j;
+        }
+    }
+    index_[i].used = false;
+    index_count_--;
+}
+
+void MessageQueue::rebuildIndex(size_t capacity) {
+    while (capacity < (size_ + 1) * 2) {
+        capacity *= 2;
+    }
+    
+    index_.assign(capacity, IndexEntry());
+    index_count_ = 0;
+    
+    for (size_t lane = 0; lane < kPriorityLevels; ++lane) {
+        for (uint64_t pos = lanes_[lane].head(); pos != lanes_[lane].tail(); ++pos) {
+            const std::string& key = lanes_[lane].at(pos).key;
+            if (key.empty()) {
+                continue;
+            }
+            
+            size_t hash = std::hash<std::string>()(key);
+            if (findSlot(key, hash) != index_.size()) {
+                continue;  // 启用合并前已存在的重复键，保留最早一条的索引
+            }
+            indexInsert(hash, static_cast<uint8_t>(lane), pos);
+        }
+    }
+}
+
+} // namespace cross_platform_websocket
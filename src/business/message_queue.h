@@ -0,0 +1,272 @@
+#pragma once
+
+#include "../core/container/ring_buffer.h"
+#include "../core/datalink/datalink.h"
+#include "../core/memory/payload.h"
+#include "../core/storage/segment_log.h"
+#include <string>
+#include <functional>
+#include <vector>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 消息优先级枚举
+ */
+enum class MessagePriority {
+    LOW = 0,
+    NORMAL = 1,
+    HIGH = 2,
+    URGENT = 3
+};
+
+/**
+ * @brief 队列溢出策略
+ */
+enum class QueueOverflowPolicy {
+    REJECT_NEWEST = 0,          // 拒绝新消息
+    DROP_OLDEST_LOW_FIRST = 1,  // 从最低优先级开始丢弃最旧的消息（不丢弃比新消息优先级更高的消息）
+    BLOCK = 2                   // 阻塞等待队列空间，超时后拒绝新消息
+};
+
+/**
+ * @brief 发送完成回调函数类型
+ *
+ * 消息完整写入传输层时以 success = true 调用；发送失败、被丢弃或
+ * 队列被清空时以 success = false 调用，reason 为失败原因。
+ * 每条消息的完成回调恰好调用一次。
+ */
+using SendCompletionCallback = std::function<void(bool success, const std::string& reason)>;
+
+/**
+ * @brief 消息队列项
+ */
+struct QueuedMessage {
+    Payload data;           // 负载（内存来自 BufferPool）
+    MessageType type;
+    MessagePriority priority;
+    uint64_t timestamp;
+    SendCompletionCallback completion;
+    uint64_t expires_at;    // 过期时间戳（毫秒），0 表示永不过期
+    uint64_t log_position;  // 持久化队列中的记录位置
+    std::string key;        // 合并键，非空时同键消息在队列中只保留最新一条
+    uint64_t accepted_ns;   // 被接受时的单调时钟时刻（纳秒），用于延迟统计，0 表示未知
+    
+    QueuedMessage()
+        : type(MessageType::TEXT), priority(MessagePriority::NORMAL), timestamp(0)
+        , expires_at(0), log_position(SegmentLog::kInvalidPosition), accepted_ns(0) {}
+    
+    QueuedMessage(const std::string& d, MessageType t, MessagePriority p)
+        : data(d), type(t), priority(p), timestamp(0)
+        , expires_at(0), log_position(SegmentLog::kInvalidPosition), accepted_ns(0) {}
+    
+    QueuedMessage(Payload&& d, MessageType t, MessagePriority p)
+        : data(std::move(d)), type(t), priority(p), timestamp(0)
+        , expires_at(0), log_position(SegmentLog::kInvalidPosition), accepted_ns(0) {}
+    
+    /**
+     * @brief 检查消息是否已过期
+     * @param now 当前时间戳（毫秒）
+     * @return 是否已过期
+     */
+    bool isExpired(uint64_t now) const {
+        return expires_at != 0 && now >= expires_at;
+    }
+};
+
+/**
+ * @brief 按优先级分道的消息队列
+ * 
+ * 每个 MessagePriority 级别对应一条 FIFO 环形缓冲区，出队时从最高优先级
+ * 的非空队列取队首。入队、出队均为 O(1)，同一优先级内严格保持 FIFO 顺序。
+ * 
+ * 本类不做同步，由 WebSocketManager 在 queue_mutex_ 下访问。
+ */
+class MessageQueue {
+public:
+    /**
+     * @brief 优先级级别数
+     */
+    static const size_t kPriorityLevels = 4;
+    
+    MessageQueue();
+    
+    /**
+     * @brief 为每个优先级队列预分配容量
+     * @param capacity 每条队列的容量
+     */
+    void reserve(size_t capacity);
+    
+    /**
+     * @brief 启用或禁用按键合并
+     * 
+     * 启用后带合并键的消息入队时，若队列中已有同键消息，则原地替换其内容，
+     * 保留原有队列位置（及原有优先级队列）。
+     * 
+     * @param enabled 是否启用
+     */
+    void setCoalescing(bool enabled);
+    
+    /**
+     * @brief 检查是否启用按键合并
+     * @return 是否启用
+     */
+    bool isCoalescing() const { return coalescing_; }
+    
+    /**
+     * @brief 查找队列中指定合并键的消息
+     * @param key 合并键
+     * @return 消息指针，未启用合并或不存在时返回 nullptr
+     */
+    QueuedMessage* find(const std::string& key);
+    
+    /**
+     * @brief 将消息移入对应优先级队列的队尾，或原地替换同键消息
+     * @param message 消息
+     * @param superseded 被替换的旧消息（可为 nullptr）
+     * @return 是否替换了同键消息
+     */
+    bool push(QueuedMessage&& message, QueuedMessage* superseded = nullptr);
+    
+    /**
+     * @brief 把刚取出的消息放回其优先级队列的队首（发送失败时使用），不检查容量上限
+     * @param message 消息
+     * @return 合并模式下队列中已有同键的新消息时不放回，返回 false，消息保持不变
+     */
+    bool pushFront(QueuedMessage& message);
+    
+    /**
+     * @brief 获取下一条待发送消息（最高优先级队列的队首）
+     * @return 消息指针，队列为空时返回 nullptr
+     */
+    QueuedMessage* front();
+    
+    /**
+     * @brief 弹出下一条待发送消息
+     * @param out 输出消息
+     * @return 队列为空时返回 false
+     */
+    bool pop(QueuedMessage& out);
+    
+    /**
+     * @brief 丢弃下一条待发送消息
+     */
+    void pop();
+    
+    /**
+     * @brief 从不高于指定优先级的队列中移出最旧的一条消息
+     * 
+     * 从 LOW 开始逐级向上查找，用于溢出时的淘汰。
+     * 
+     * @param max_priority 可淘汰的最高优先级
+     * @param out 被淘汰的消息
+     * @return 没有可淘汰的消息时返回 false
+     */
+    bool evictOldest(MessagePriority max_priority, QueuedMessage& out);
+    
+    /**
+     * @brief 清空所有优先级队列
+     */
+    void clear();
+    
+    /**
+     * @brief 获取所有队列中的消息总数
+     * @return 消息数量
+     */
+    size_t size() const;
+    
+    /**
+     * @brief 检查是否为空
+     * @return 是否为空
+     */
+    bool empty() const;
+    
+    /**
+     * @brief 获取所有队列中消息负载的总字节数
+     * @return 字节数
+     */
+    size_t bytes() const;
+    
+    /**
+     * @brief 获取不高于指定优先级的消息数量
+     * @param max_priority 最高优先级
+     * @return 消息数量
+     */
+    size_t sizeAtOrBelow(MessagePriority max_priority) const;
+    
+    /**
+     * @brief 获取不高于指定优先级的消息负载字节数
+     * @param max_priority 最高优先级
+     * @return 字节数
+     */
+    size_t bytesAtOrBelow(MessagePriority max_priority) const;
+
+private:
+    RingBuffer<QueuedMessage> lanes_[kPriorityLevels];
+    size_t lane_bytes_[kPriorityLevels];
+    size_t size_;
+    size_t bytes_;
+    
+    /**
+     * @brief 合并键索引项，指向某条优先级队列中的绝对位置
+     */
+    struct IndexEntry {
+        size_t hash;
+        uint64_t position;
+        uint8_t lane;
+        bool used;
+        
+        IndexEntry() : hash(0), position(0), lane(0), used(false) {}
+    };
+    
+    // 开放寻址（线性探测）哈希索引：合并键 -> 环形缓冲区位置
+    bool coalescing_;
+    std::vector<IndexEntry> index_;
+    size_t index_count_;
+    
+    /**
+     * @brief 获取消息所属的队列下标
+     * @param priority 消息优先级
+     * @return 队列下标
+     */
+    static size_t laneIndex(MessagePriority priority);
+    
+    /**
+     * @brief 获取最高优先级非空队列
+     * @return 队列指针，全部为空时返回 nullptr
+     */
+    RingBuffer<QueuedMessage>* topLane();
+    
+    /**
+     * @brief 从指定队列弹出队首并更新计数
+     * @param lane 队列下标
+     * @param out 输出消息
+     */
+    void popFrom(size_t lane, QueuedMessage& out);
+    
+    /**
+     * @brief 查找合并键对应的索引槽
+     * @param key 合并键
+     * @param hash 合并键哈希
+     * @return 索引槽下标，不存在时返回 index_.size()
+     */
+    size_t findSlot(const std::string& key, size_t hash);
+    
+    /**
+     * @brief 插入索引项（调用前需保证索引有空位）
+     */
+    void indexInsert(size_t hash, uint8_t lane, uint64_t position);
+    
+    /**
+     * @brief 删除指向指定位置的索引项（向后移位删除，不留墓碑）
+     */
+    void indexErase(const std::string& key, uint8_t lane, uint64_t position);
+    
+    /**
+     * @brief 按当前队列内容重建索引
+     * @param capacity 索引容量（2 的幂）
+     */
+    void rebuildIndex(size_t capacity);
+};
+
+} // namespace cross_platform_websocket
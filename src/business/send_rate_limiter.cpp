@@ -0,0 +1,81 @@
+#include "send_rate_limiter.h"
+#include <algorithm>
+
+namespace cross_platform_websocket {
+
+void SendRateLimiter::BucketPair::configure(const RateLimitOptions& options) {
+    messages.configure(options.messages_per_second,
+                       options.message_burst > 0.0 ? options.message_burst : options.messages_per_second);
+    bytes.configure(options.bytes_per_second,
+                    options.byte_burst > 0.0 ? options.byte_burst : options.bytes_per_second);
+}
+
+SendRateLimiter::SendRateLimiter() {
+}
+
+void SendRateLimiter::setLimit(const RateLimitOptions& options) {
+    connection_.configure(options);
+}
+
+void SendRateLimiter::setPriorityLimit(MessagePriority priority, const RateLimitOptions& options) {
+    BucketPair* lane = laneBuckets(priority);
+    if (lane) {
+        lane->configure(options);
+    }
+}
+
+bool SendRateLimiter::isLimited() const {
+    if (connection_.messages.isLimited() || connection_.bytes.isLimited()) {
+        return true;
+    }
+    for (size_t i = 0; i < MessageQueue::kPriorityLevels; ++i) {
+        if (lanes_[i].messages.isLimited() || lanes_[i].bytes.isLimited()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SendRateLimiter::tryAcquire(MessagePriority priority, size_t bytes) {
+    BucketPair* lane = laneBuckets(priority);
+    TokenBucket* buckets[4] = {
+        &connection_.messages, &connection_.bytes,
+        lane ? &lane->messages : nullptr, lane ? &lane->bytes : nullptr
+    };
+    double tokens[4] = { 1.0, static_cast<double>(bytes), 1.0, static_cast<double>(bytes) };
+    
+    for (size_t i = 0; i < 4; ++i) {
+        if (buckets[i] && !buckets[i]->tryAcquire(tokens[i])) {
+            while (i-- > 0) {
+                if (buckets[i]) {
+                    buckets[i]->refund(tokens[i]);
+                }
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t SendRateLimiter::waitNanos(MessagePriority priority, size_t bytes) const {
+    double byte_tokens = static_cast<double>(bytes);
+    uint64_t wait = std::max(connection_.messages.waitNanos(), connection_.bytes.waitNanos(byte_tokens));
+    
+    const BucketPair* lane = laneBuckets(priority);
+    if (lane) {
+        wait = std::max(wait, std::max(lane->messages.waitNanos(), lane->bytes.waitNanos(byte_tokens)));
+    }
+    return wait;
+}
+
+SendRateLimiter::BucketPair* SendRateLimiter::laneBuckets(MessagePriority priority) {
+    size_t lane = static_cast<size_t>(priority);
+    return lane < MessageQueue::kPriorityLevels ? &lanes_[lane] : nullptr;
+}
+
+const SendRateLimiter::BucketPair* SendRateLimiter::laneBuckets(MessagePriority priority) const {
+    size_t lane = static_cast<size_t>(priority);
+    return lane < MessageQueue::kPriorityLevels ? &lanes_[lane] : nullptr;
+}
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "message_queue.h"
+#include "../core/ratelimit/token_bucket.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 超出发送速率时的处理方式
+ */
+enum class RateLimitAction {
+    QUEUE = 0,   // 加入消息队列，由排空线程按速率补发（未启用队列时拒绝）
+    REJECT = 1   // 直接拒绝
+};
+
+/**
+ * @brief 速率限制配置（各项为 0 表示不限制）
+ */
+struct RateLimitOptions {
+    double messages_per_second;  // 每秒消息数
+    double message_burst;        // 消息数突发容量（0 表示等于每秒消息数）
+    double bytes_per_second;     // 每秒字节数
+    double byte_burst;           // 字节数突发容量（0 表示等于每秒字节数）
+    
+    RateLimitOptions()
+        : messages_per_second(0.0)
+        , message_burst(0.0)
+        , bytes_per_second(0.0)
+        , byte_burst(0.0) {}
+};
+
+/**
+ * @brief 出站发送速率限制器
+ * 
+ * 连接级和各优先级分别持有消息数、字节数两个令牌桶，发送需同时通过
+ * 连接级和所属优先级的桶。检查全程无锁：未配置的桶只有一次原子读取，
+ * 已配置的桶为一次时钟读取加一次 CAS。
+ */
+class SendRateLimiter {
+public:
+    SendRateLimiter();
+    
+    /**
+     * @brief 设置连接级速率限制
+     * @param options 速率限制配置
+     */
+    void setLimit(const RateLimitOptions& options);
+    
+    /**
+     * @brief 设置指定优先级的速率限制
+     * @param priority 消息优先级
+     * @param options 速率限制配置
+     */
+    void setPriorityLimit(MessagePriority priority, const RateLimitOptions& options);
+    
+    /**
+     * @brief 检查是否配置了任何限制
+     * @return 是否限速
+     */
+    bool isLimited() const;
+    
+    /**
+     * @brief 尝试为一条消息取出令牌（任一桶不足时回滚已取出的令牌）
+     * @param priority 消息优先级
+     * @param bytes 消息字节数
+     * @return 是否允许发送
+     */
+    bool tryAcquire(MessagePriority priority, size_t bytes);
+    
+    /**
+     * @brief 估算一条消息还需等待多久才能通过
+     * @param priority 消息优先级
+     * @param bytes 消息字节数
+     * @return 等待时间（纳秒）
+     */
+    uint64_t waitNanos(MessagePriority priority, size_t bytes) const;
+
+private:
+    SendRateLimiter(const SendRateLimiter&) = delete;
+    SendRateLimiter& operator=(const SendRateLimiter&) = delete;
+    
+    /**
+     * @brief 一组消息数和字节数令牌桶
+     */
+    struct BucketPair {
+        TokenBucket messages;
+        TokenBucket bytes;
+        
+        void configure(const RateLimitOptions& options);
+    };
+    
+    BucketPair* laneBuckets(MessagePriority priority);
+    const BucketPair* laneBuckets(MessagePriority priority) const;
+    
+    BucketPair connection_;
+    BucketPair lanes_[MessageQueue::kPriorityLevels];
+};
+
+} // namespace cross_platform_websocket
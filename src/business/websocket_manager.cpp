@@ -3,29 +3,59 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <limits>
+#include <chrono>
 
 namespace cross_platform_websocket {
 
+// 消息队列预分配的最大总槽位数（平均分给各优先级），超出后各优先级队列按需扩容
+static const size_t kMaxPreallocatedQueueCapacity = 4096;
+
+// 排空线程限速等待的最长单次睡眠（毫秒），保证停止请求能及时响应
+static const int kMaxDrainWaitMs = 100;
+
+// 连接仍在但发送失败时，排空线程重试的初始等待（毫秒），之后按倍数增加到 kMaxDrainWaitMs
+static const int kMinDrainRetryMs = 5;
+
 WebSocketManager::WebSocketManager(std::shared_ptr<PlatformInterface> platform,
                                    std::shared_ptr<Logger> logger)
     : platform_(platform)
     , logger_(logger)
     , queue_enabled_(false)
     , max_queue_size_(1000)
+    , max_queue_bytes_(std::numeric_limits<size_t>::max())
+    , overflow_policy_(QueueOverflowPolicy::REJECT_NEWEST)
+    , block_timeout_ms_(0)
+    , rate_limit_action_(RateLimitAction::QUEUE)
+    , fragment_size_(0)
+    , scheduler_thread_(nullptr)
+    , scheduler_thread_running_(false)
+    , drain_batch_size_(64)
+    , drain_thread_(nullptr)
+    , drain_running_(false)
     , heartbeat_enabled_(false)
     , heartbeat_interval_ms_(30000)  // 30秒
     , heartbeat_thread_(nullptr)
     , heartbeat_thread_running_(false)
-    , messages_sent_success_(0)
-    , messages_sent_failed_(0)
-    , messages_received_(0) {
+    , send_latency_(LatencyHistogram::kShortValueBits)
+    , latency_tracking_(true) {
+    
+    for (size_t i = 0; i < MessageQueue::kPriorityLevels; ++i) {
+        message_ttl_ms_[i] = 0;
+    }
     
     LOG_INFO("WebSocket 管理器创建");
 }
 
 WebSocketManager::~WebSocketManager() {
+    // 先发送已调度的消息，再断开连接
+    stopScheduler();
     disconnect();
     stopHeartbeat();
+    // 先关闭持久化队列，未发送的消息保留在磁盘上供下次回放
+    disablePersistentQueue();
+    failQueuedMessages("管理器已销毁");
+    std::atomic_store(&reliable_channel_, std::shared_ptr<ReliableChannel>());
     LOG_INFO("WebSocket 管理器销毁");
 }
 
@@ -41,6 +71,7 @@ bool WebSocketManager::initialize() {
             [this](const WebSocketMessage& msg) { onMessageReceived(msg); });
         datalink_->setErrorCallback(
             [this](const std::string& error) { onError(error); });
+        datalink_->enableLatencyTracking(latency_tracking_);
         
         LOG_INFO("WebSocket 管理器初始化成功");
         return true;
@@ -67,101 +98,216 @@ void WebSocketManager::disconnect() {
     if (datalink_) {
         datalink_->disconnect();
     }
+    stopDrain();
     stopHeartbeat();
     LOG_INFO("WebSocket 连接已断开");
 }
 
 bool WebSocketManager::sendText(const std::string& message, MessagePriority priority) {
+    return sendText(message, priority, SendCompletionCallback());
+}
+
+bool WebSocketManager::sendText(const std::string& message, MessagePriority priority,
+                                SendCompletionCallback completion) {
+    return sendMessage(std::string(), message.data(), message.size(), nullptr,
+                       MessageType::TEXT, priority, completion);
+}
+
+bool WebSocketManager::sendText(Payload&& message, MessagePriority priority,
+                                SendCompletionCallback completion) {
+    return sendMessage(std::string(), message.data(), message.size(), &message,
+                       MessageType::TEXT, priority, completion);
+}
+
+bool WebSocketManager::sendKeyedText(const std::string& key, const std::string& message,
+                                     MessagePriority priority, SendCompletionCallback completion) {
+    return sendMessage(key, message.data(), message.size(), nullptr,
+                       MessageType::TEXT, priority, completion);
+}
+
+bool WebSocketManager::sendBinary(const std::vector<uint8_t>& data, MessagePriority priority) {
+    return sendBinary(data, priority, SendCompletionCallback());
+}
+
+bool WebSocketManager::sendBinary(const std::vector<uint8_t>& data, MessagePriority priority,
+                                  SendCompletionCallback completion) {
+    return sendBinary(data.data(), data.size(), priority, completion);
+}
+
+bool WebSocketManager::sendBinary(const uint8_t* data, size_t length, MessagePriority priority,
+                                  SendCompletionCallback completion) {
+    return sendMessage(std::string(), reinterpret_cast<const char*>(data), length,
+                       nullptr, MessageType::BINARY, priority, completion);
+}
+
+bool WebSocketManager::sendBinary(Payload&& data, MessagePriority priority,
+                                  SendCompletionCallback completion) {
+    return sendMessage(std::string(), data.data(), data.size(), &data,
+                       MessageType::BINARY, priority, completion);
+}
+
+bool WebSocketManager::sendShared(const SharedPayload& payload, MessageType type,
+                                  MessagePriority priority, SendCompletionCallback completion) {
+    Payload body(payload);
+    return sendMessage(std::string(), body.data(), body.size(), &body,
+                       type, priority, completion);
+}
+
+bool WebSocketManager::sendMessage(const std::string& key, const char* data, size_t size,
+                                   Payload* body, MessageType type,
+                                   MessagePriority priority, SendCompletionCallback completion) {
     if (!datalink_) {
         LOG_ERROR("数据链路层未初始化");
+        if (completion) {
+            completion(false, "未初始化");
+        }
         return false;
     }
     
-    if (!isConnected()) {
+    std::shared_ptr<ReliableChannel> reliable = std::atomic_load(&reliable_channel_);
+    if (reliable) {
+        return sendReliable(*reliable, data, size, type, completion);
+    }
+    
+    uint64_t accepted_ns = LatencyHistogram::nowNanos();
+    // 成功/失败回调只针对文本消息，且仅在设置了回调时才构造字符串
+    bool is_text = type == MessageType::TEXT;
+    const char* label = is_text ? "消息" : "二进制消息";
+    // 告警和错误日志的描述只在对应级别启用时才拼接
+    auto describe = [&](const std::string& what) {
+        return label + what + "，大小: " + std::to_string(size) + " 字节";
+    };
+    // 入队或调度时优先转移调用方交出的负载，否则复制一次
+    auto takeBody = [&]() { return body ? std::move(*body) : Payload(data, size); };
+    auto notifyFailure = [&](const std::string& reason) {
+        stats_.add(STAT_SENT_FAILED);
+        if (is_text && send_failure_callback_) {
+            send_failure_callback_(std::string(data, size), reason);
+        }
+        if (completion) {
+            completion(false, reason);
+        }
+    };
+    
+    // 积压排空期间，非紧急消息排在积压之后以保持顺序，紧急消息直接发送
+    bool connected = isConnected();
+    bool behind_backlog = connected && priority != MessagePriority::URGENT && drain_running_;
+    
+    // 超出发送速率时按配置入队补发或直接拒绝
+    bool throttled = connected && !behind_backlog && !rate_limiter_.tryAcquire(priority, size);
+    if (throttled) {
+        stats_.add(STAT_THROTTLED);
+        if (rate_limit_action_ == RateLimitAction::REJECT || !queue_enabled_) {
+            LOG_WARNING("超出发送速率限制，拒绝" + describe(""));
+            notifyFailure("超出发送速率限制");
+            return false;
+        }
+    }
+    
+    if (!connected || behind_backlog || throttled) {
         if (queue_enabled_) {
-            // 将消息加入队列
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            if (message_queue_.size() < max_queue_size_) {
-                QueuedMessage queued_msg(message, MessageType::TEXT, priority);
-                queued_msg.timestamp = platform_->getCurrentTimestamp();
-                message_queue_.push(queued_msg);
-                LOG_DEBUG("消息已加入队列: " + message);
-                return true;
-            } else {
-                LOG_WARNING("消息队列已满，丢弃消息: " + message);
-                messages_sent_failed_++;
-                if (send_failure_callback_) {
-                    send_failure_callback_(message, "队列已满");
+            // 将消息加入队列（在锁外构造，入队时移动）
+            QueuedMessage queued_msg(takeBody(), type, priority);
+            queued_msg.timestamp = platform_->getCurrentTimestamp();
+            queued_msg.completion = completion;
+            queued_msg.key = key;
+            queued_msg.accepted_ns = accepted_ns;
+            std::string reason;
+            if (enqueueMessage(std::move(queued_msg), reason)) {
+                LOG_DEBUGF("{}已加入队列，大小: {} 字节", label, size);
+                // 入队期间可能已连接或排空刚结束，确保消息不会滞留
+                if (isConnected()) {
+                    startDrain();
                 }
-                return false;
+                return true;
             }
-        } else {
-            LOG_ERROR("WebSocket 未连接，无法发送消息");
-            messages_sent_failed_++;
-            if (send_failure_callback_) {
-                send_failure_callback_(message, "未连接");
+            
+            // 入队失败时消息未被移走，取回负载供失败回调使用
+            if (body) {
+                *body = std::move(queued_msg.data);
+                data = body->data();
             }
+            
+            // 回调在锁外调用，允许回调中再次发送
+            LOG_WARNING(describe("入队失败（" + reason + "），丢弃消息"));
+            notifyFailure(reason);
+            return false;
+        } else {
+            LOG_ERROR(std::string("WebSocket 未连接，无法发送") + label);
+            notifyFailure("未连接");
             return false;
         }
     }
     
-    // 直接发送消息
-    if (datalink_->sendText(message)) {
-        messages_sent_success_++;
-        LOG_DEBUG("消息发送成功: " + message);
-        if (send_success_callback_) {
-            send_success_callback_(message);
+    // 启用公平调度时交给发送线程
+    if (scheduler_thread_running_) {
+        QueuedMessage scheduled(takeBody(), type, priority);
+        scheduled.completion = completion;
+        scheduled.accepted_ns = accepted_ns;
+        if (scheduleMessage(std::move(scheduled))) {
+            return true;
+        }
+        // 调度线程已停止，取回负载以便下面直接发送
+        if (body) {
+            *body = std::move(scheduled.data);
+            data = body->data();
+        }
+    }
+    
+    // 直接发送，帧头和掩码由传输层按连接生成，负载不再复制
+    if (datalink_->sendData(data, size, !is_text)) {
+        send_latency_.recordSince(accepted_ns);
+        stats_.add(STAT_SENT_SUCCESS);
+        LOG_DEBUGF("{}发送成功，大小: {} 字节", label, size);
+        if (is_text && send_success_callback_) {
+            send_success_callback_(std::string(data, size));
+        }
+        if (completion) {
+            completion(true, "");
         }
         return true;
     } else {
-        messages_sent_failed_++;
-        LOG_ERROR("消息发送失败: " + message);
-        if (send_failure_callback_) {
-            send_failure_callback_(message, "发送失败");
-        }
+        LOG_ERROR(describe("发送失败"));
+        notifyFailure("发送失败");
         return false;
     }
 }
 
-bool WebSocketManager::sendBinary(const std::vector<uint8_t>& data, MessagePriority priority) {
-    if (!datalink_) {
-        LOG_ERROR("数据链路层未初始化");
-        return false;
-    }
+bool WebSocketManager::sendReliable(ReliableChannel& channel, const char* data, size_t size,
+                                    MessageType type, SendCompletionCallback completion) {
+    // 成功/失败回调需要消息内容时才保留一份副本
+    bool notify = type == MessageType::TEXT && (send_success_callback_ || send_failure_callback_);
+    std::string text = notify ? std::string(data, size) : std::string();
     
-    if (!isConnected()) {
-        if (queue_enabled_) {
-            // 将二进制消息转换为字符串并加入队列
-            std::string binary_str(data.begin(), data.end());
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            if (message_queue_.size() < max_queue_size_) {
-                QueuedMessage queued_msg(binary_str, MessageType::BINARY, priority);
-                queued_msg.timestamp = platform_->getCurrentTimestamp();
-                message_queue_.push(queued_msg);
-                LOG_DEBUG("二进制消息已加入队列，大小: " + std::to_string(data.size()) + " 字节");
-                return true;
+    bool accepted = channel.send(data, size, type,
+        [this, notify, text, completion](bool success, const std::string& reason) {
+            if (success) {
+                stats_.add(STAT_SENT_SUCCESS);
+                if (notify && send_success_callback_) {
+                    send_success_callback_(text);
+                }
             } else {
-                LOG_WARNING("消息队列已满，丢弃二进制消息");
-                messages_sent_failed_++;
-                return false;
+                stats_.add(STAT_SENT_FAILED);
+                if (notify && send_failure_callback_) {
+                    send_failure_callback_(text, reason);
+                }
             }
-        } else {
-            LOG_ERROR("WebSocket 未连接，无法发送二进制消息");
-            messages_sent_failed_++;
-            return false;
-        }
-    }
+            if (completion) {
+                completion(success, reason);
+            }
+        });
     
-    // 直接发送二进制消息
-    if (datalink_->sendBinary(data)) {
-        messages_sent_success_++;
-        LOG_DEBUG("二进制消息发送成功，大小: " + std::to_string(data.size()) + " 字节");
-        return true;
-    } else {
-        messages_sent_failed_++;
-        LOG_ERROR("二进制消息发送失败");
-        return false;
+    if (!accepted) {
+        stats_.add(STAT_SENT_FAILED);
+        LOG_WARNING("可靠通道待发送队列已满，丢弃消息，大小: " + std::to_string(size) + " 字节");
+        if (notify && send_failure_callback_) {
+            send_failure_callback_(text, "可靠通道已满");
+        }
+        if (completion) {
+            completion(false, "可靠通道已满");
+        }
     }
+    return accepted;
 }
 
 bool WebSocketManager::sendPing() {
@@ -206,6 +352,12 @@ void WebSocketManager::enableMessageQueue(bool enabled, size_t max_queue_size) {
     max_queue_size_ = max_queue_size;
     
     if (enabled) {
+        // 按总容量平均预分配各优先级队列，消息集中在某一优先级时再按倍数扩容
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            size_t total = std::min(max_queue_size, kMaxPreallocatedQueueCapacity);
+            message_queue_.reserve((total + MessageQueue::kPriorityLevels - 1) / MessageQueue::kPriorityLevels);
+        }
         LOG_INFO("启用消息队列，最大大小: " + std::to_string(max_queue_size));
     } else {
         LOG_INFO("禁用消息队列");
@@ -213,34 +365,667 @@ void WebSocketManager::enableMessageQueue(bool enabled, size_t max_queue_size) {
     }
 }
 
-void WebSocketManager::processMessageQueue() {
-    if (!queue_enabled_ || !isConnected()) {
+void WebSocketManager::setMessageQueueLimits(size_t max_queue_bytes, QueueOverflowPolicy policy,
+                                             int block_timeout_ms) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        max_queue_bytes_ = max_queue_bytes;
+        overflow_policy_ = policy;
+        block_timeout_ms_ = block_timeout_ms;
+    }
+    queue_space_cv_.notify_all();
+    
+    LOG_INFO("设置消息队列字节上限: " + std::to_string(max_queue_bytes) +
+             "，溢出策略: " + std::to_string(static_cast<int>(policy)) +
+             "，阻塞超时: " + std::to_string(block_timeout_ms) + "ms");
+}
+
+bool WebSocketManager::enqueueMessage(QueuedMessage&& message, std::string& reason) {
+    std::vector<QueuedMessage> evicted;
+    QueuedMessage superseded;
+    bool replaced = false;
+    bool accepted = false;
+    
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        
+        bool has_space = false;
+        const QueuedMessage* existing = message_queue_.find(message.key);
+        if (existing) {
+            // 同键消息原地替换并沿用其优先级，TTL 和持久化记录都按该优先级计算
+            message.priority = existing->priority;
+            // 不增加条数，只需检查字节增量
+            has_space = message_queue_.bytes() - existing->data.size() + message.data.size() <= max_queue_bytes_;
+            if (!has_space) {
+                reason = "队列已满";
+            }
+        } else {
+            has_space = makeQueueSpace(lock, message.priority, message.data.size(), evicted, reason);
+        }
+        
+        if (has_space) {
+            applyMessageTTL(message);
+            if (persistent_log_ &&
+                !persistent_log_->append(static_cast<uint8_t>(message.type),
+                                         static_cast<uint8_t>(message.priority),
+                                         message.timestamp, message.data.data(),
+                                         message.data.size(), message.log_position,
+                                         message.key)) {
+                reason = "持久化队列已满";
+                // 新消息未被接受，为它腾出空间而淘汰的消息按原顺序放回队首，不丢弃也不标记消费
+                for (auto it = evicted.rbegin(); it != evicted.rend(); ++it) {
+                    message_queue_.pushFront(*it);
+                }
+                evicted.clear();
+            } else {
+                replaced = message_queue_.push(std::move(message), &superseded);
+                accepted = true;
+            }
+        }
+        
+        if (persistent_log_ && replaced) {
+            persistent_log_->markConsumed(superseded.log_position);
+        }
+        
+        if (persistent_log_) {
+            for (const auto& victim : evicted) {
+                persistent_log_->markConsumed(victim.log_position);
+            }
+        }
+    }
+    
+    if (replaced) {
+        stats_.add(STAT_COALESCED);
+        if (superseded.completion) {
+            superseded.completion(false, "已被同键新消息替换");
+        }
+    }
+    
+    // 被淘汰消息的回调在锁外调用
+    notifyEvicted(evicted);
+    
+    return accepted;
+}
+
+void WebSocketManager::notifyEvicted(std::vector<QueuedMessage>& evicted) {
+    for (auto& victim : evicted) {
+        stats_.add(STAT_SENT_FAILED);
+        stats_.add(STAT_EVICTED);
+        LOG_WARNING("消息队列溢出，丢弃优先级 " + std::to_string(static_cast<int>(victim.priority)) +
+                    " 的最旧消息，大小: " + std::to_string(victim.data.size()) + " 字节");
+        if (victim.type == MessageType::TEXT && send_failure_callback_) {
+            send_failure_callback_(victim.data.str(), "队列溢出被丢弃");
+        }
+        if (victim.completion) {
+            victim.completion(false, "队列溢出被丢弃");
+        }
+    }
+}
+
+bool WebSocketManager::makeQueueSpace(std::unique_lock<std::mutex>& lock, MessagePriority priority,
+                                      size_t bytes, std::vector<QueuedMessage>& evicted,
+                                      std::string& reason, bool may_block) {
+    if (bytes > max_queue_bytes_ || max_queue_size_ == 0) {
+        reason = "消息超过队列上限";
+        return false;
+    }
+    
+    auto fits = [this, bytes]() {
+        return message_queue_.size() < max_queue_size_ &&
+               message_queue_.bytes() + bytes <= max_queue_bytes_;
+    };
+    
+    if (fits()) {
+        return true;
+    }
+    
+    switch (overflow_policy_) {
+        case QueueOverflowPolicy::DROP_OLDEST_LOW_FIRST: {
+            // 先确认淘汰不高于新消息优先级的消息后能放下，避免白白丢弃
+            size_t keep_count = message_queue_.size() - message_queue_.sizeAtOrBelow(priority);
+            size_t keep_bytes = message_queue_.bytes() - message_queue_.bytesAtOrBelow(priority);
+            if (keep_count >= max_queue_size_ || keep_bytes + bytes > max_queue_bytes_) {
+                reason = "队列已满";
+                return false;
+            }
+            
+            while (!fits()) {
+                QueuedMessage victim;
+                message_queue_.evictOldest(priority, victim);
+                evicted.push_back(std::move(victim));
+            }
+            return true;
+        }
+        
+        case QueueOverflowPolicy::BLOCK: {
+            if (!may_block) {
+                reason = "队列已满";
+                return false;
+            }
+            bool ready = queue_space_cv_.wait_for(
+                lock, std::chrono::milliseconds(block_timeout_ms_),
+                [this, &fits]() { return !queue_enabled_ || fits(); });
+            if (!queue_enabled_) {
+                reason = "消息队列已禁用";
+                return false;
+            }
+            if (!ready) {
+                reason = "队列已满，等待超时";
+                return false;
+            }
+            return true;
+        }
+        
+        case QueueOverflowPolicy::REJECT_NEWEST:
+        default:
+            reason = "队列已满";
+            return false;
+    }
+}
+
+void WebSocketManager::setMessageTTL(MessagePriority priority, uint64_t ttl_ms) {
+    size_t lane = static_cast<size_t>(priority);
+    if (lane >= MessageQueue::kPriorityLevels) {
         return;
     }
     
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        message_ttl_ms_[lane] = ttl_ms;
+    }
+    LOG_INFO("设置优先级 " + std::to_string(lane) + " 的消息存活时间: " + std::to_string(ttl_ms) + "ms");
+}
+
+void WebSocketManager::applyMessageTTL(QueuedMessage& message) const {
+    size_t lane = static_cast<size_t>(message.priority);
+    if (message.expires_at == 0 && lane < MessageQueue::kPriorityLevels && message_ttl_ms_[lane] > 0) {
+        message.expires_at = message.timestamp + message_ttl_ms_[lane];
+    }
+}
+
+void WebSocketManager::enableMessageCoalescing(bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        message_queue_.setCoalescing(enabled);
+    }
+    LOG_INFO(enabled ? "启用队列消息按键合并" : "禁用队列消息按键合并");
+}
+
+bool WebSocketManager::enablePersistentQueue(const SegmentLogOptions& options) {
+    std::unique_ptr<SegmentLog> log(new SegmentLog());
+    std::vector<QueuedMessage> replayed;
+    std::vector<QueuedMessage> stale;
+    std::vector<QueuedMessage> evicted;
+    size_t recovered = 0;
+    size_t rejected = 0;
+    
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        
+        if (persistent_log_) {
+            LOG_WARNING("持久化队列已启用，忽略重复调用");
+            return true;
+        }
+        
+        // 先收集回放记录，打开成功后再统一入队
+        bool opened = log->open(options, [&replayed](const SegmentLogRecord& record) {
+            QueuedMessage queued_msg(std::string(), static_cast<MessageType>(record.type),
+                                     static_cast<MessagePriority>(record.priority));
+            queued_msg.data.assign(record.data, record.length);
+            queued_msg.timestamp = record.timestamp;
+            queued_msg.log_position = record.position;
+            queued_msg.key.assign(record.key, record.key_length);
+            replayed.push_back(std::move(queued_msg));
+        });
+        
+        if (!opened) {
+            LOG_ERROR("打开持久化队列失败: " + options.directory);
+            return false;
+        }
+        
+        // 移除来自已关闭日志的消息，它们仍在磁盘上，由回放重新入队，避免重复
+        QueuedMessage queued_msg;
+        std::vector<QueuedMessage> kept;
+        while (message_queue_.pop(queued_msg)) {
+            if (queued_msg.log_position != SegmentLog::kInvalidPosition) {
+                stale.push_back(std::move(queued_msg));
+            } else {
+                kept.push_back(std::move(queued_msg));
+            }
+        }
+        for (auto& message : kept) {
+            message_queue_.push(std::move(message));
+        }
+        
+        // 各优先级队列内保持原有追加顺序，按与 enqueueMessage 相同的上限和溢出策略入队
+        for (auto& message : replayed) {
+            bool has_space = false;
+            std::string reason;
+            const QueuedMessage* existing = message_queue_.find(message.key);
+            if (existing) {
+                message.priority = existing->priority;
+                has_space = message_queue_.bytes() - existing->data.size() + message.data.size() <= max_queue_bytes_;
+            } else {
+                size_t first_victim = evicted.size();
+                has_space = makeQueueSpace(lock, message.priority, message.data.size(), evicted,
+                                           reason, false);
+                for (size_t i = first_victim; i < evicted.size(); ++i) {
+                    log->markConsumed(evicted[i].log_position);
+                }
+            }
+            
+            if (!has_space) {
+                log->markConsumed(message.log_position);
+                rejected++;
+                continue;
+            }
+            
+            applyMessageTTL(message);
+            QueuedMessage superseded;
+            if (message_queue_.push(std::move(message), &superseded)) {
+                log->markConsumed(superseded.log_position);
+            } else {
+                recovered++;
+            }
+        }
+        
+        persistent_log_ = std::move(log);
+    }
+    
+    for (auto& message : stale) {
+        if (message.completion) {
+            message.completion(false, "持久化队列已重新打开，消息由回放重新入队");
+        }
+    }
+    notifyEvicted(evicted);
+    
+    if (rejected > 0) {
+        LOG_WARNING("持久化队列回放超出队列上限，丢弃消息数: " + std::to_string(rejected));
+    }
+    LOG_INFO("启用持久化队列: " + options.directory + "，恢复消息数: " + std::to_string(recovered));
+    return true;
+}
+
+void WebSocketManager::disablePersistentQueue() {
     std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (persistent_log_) {
+        persistent_log_->close();
+        persistent_log_.reset();
+        LOG_INFO("持久化队列已关闭");
+    }
+}
+
+void WebSocketManager::setQueueDrainRate(double messages_per_second, size_t batch_size) {
+    drain_batch_size_ = batch_size > 0 ? batch_size : 1;
+    drain_bucket_.configure(messages_per_second, static_cast<double>(drain_batch_size_));
+    
+    LOG_INFO("设置队列排空速率: " + std::to_string(messages_per_second) +
+             " 条/秒，每批: " + std::to_string(drain_batch_size_) + " 条");
+}
+
+void WebSocketManager::setRateLimit(const RateLimitOptions& options) {
+    rate_limiter_.setLimit(options);
+    LOG_INFO("设置出站速率限制: " + std::to_string(options.messages_per_second) + " 条/秒，" +
+             std::to_string(options.bytes_per_second) + " 字节/秒");
+}
+
+void WebSocketManager::setPriorityRateLimit(MessagePriority priority, const RateLimitOptions& options) {
+    rate_limiter_.setPriorityLimit(priority, options);
+    LOG_INFO("设置优先级 " + std::to_string(static_cast<int>(priority)) + " 的出站速率限制: " +
+             std::to_string(options.messages_per_second) + " 条/秒，" +
+             std::to_string(options.bytes_per_second) + " 字节/秒");
+}
+
+void WebSocketManager::setRateLimitAction(RateLimitAction action) {
+    rate_limit_action_ = action;
+    LOG_INFO(action == RateLimitAction::QUEUE ? "超出速率的消息将加入队列" : "超出速率的消息将被拒绝");
+}
+
+uint64_t WebSocketManager::getThrottledMessageCount() const {
+    return stats_.get(STAT_THROTTLED);
+}
+
+void WebSocketManager::enableFairScheduling(bool enabled, size_t fragment_size) {
+    if (!enabled) {
+        stopScheduler();
+        LOG_INFO("禁用加权公平发送调度");
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        fragment_size_ = fragment_size;
+        scheduler_.setQuantum(fragment_size > 0 ? fragment_size : 16 * 1024);
+        
+        if (!scheduler_thread_running_) {
+            scheduler_thread_running_ = true;
+            scheduler_thread_ = platform_->createThread(schedulerThread, this);
+            if (!scheduler_thread_) {
+                scheduler_thread_running_ = false;
+                LOG_ERROR("创建发送调度线程失败");
+                return;
+            }
+        }
+    }
+    
+    LOG_INFO("启用加权公平发送调度，分片大小: " + std::to_string(fragment_size) + " 字节");
+}
+
+void WebSocketManager::setPriorityWeight(MessagePriority priority, uint32_t weight) {
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        scheduler_.setWeight(priority, weight);
+    }
+    LOG_INFO("设置优先级 " + std::to_string(static_cast<int>(priority)) +
+             " 的调度权重: " + std::to_string(weight));
+}
+
+bool WebSocketManager::scheduleMessage(QueuedMessage&& message) {
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        if (!scheduler_thread_running_) {
+            return false;
+        }
+        message.timestamp = platform_->getCurrentTimestamp();
+        scheduler_.push(std::move(message));
+    }
+    scheduler_cv_.notify_one();
+    return true;
+}
+
+void WebSocketManager::stopScheduler() {
+    void* thread = nullptr;
     
-    while (!message_queue_.empty()) {
-        const QueuedMessage& queued_msg = message_queue_.top();
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        scheduler_thread_running_ = false;
+        thread = scheduler_thread_;
+        scheduler_thread_ = nullptr;
+    }
+    scheduler_cv_.notify_all();
+    
+    if (thread) {
+        platform_->joinThread(thread);
+    }
+}
+
+void WebSocketManager::schedulerThread(void* arg) {
+    WebSocketManager* manager = static_cast<WebSocketManager*>(arg);
+    manager->performScheduledSends();
+}
+
+void WebSocketManager::performScheduledSends() {
+    while (true) {
+        QueuedMessage message;
+        size_t fragment_size = 0;
         
-        bool sent = false;
-        if (queued_msg.type == MessageType::TEXT) {
-            sent = datalink_->sendText(queued_msg.data);
-        } else if (queued_msg.type == MessageType::BINARY) {
-            std::vector<uint8_t> binary_data(queued_msg.data.begin(), queued_msg.data.end());
-            sent = datalink_->sendBinary(binary_data);
+        {
+            std::unique_lock<std::mutex> lock(scheduler_mutex_);
+            scheduler_cv_.wait(lock, [this]() {
+                return !scheduler_thread_running_ || !scheduler_.empty();
+            });
+            
+            // 停止后仍发送完已调度的消息
+            if (!scheduler_.pop(message)) {
+                return;
+            }
+            fragment_size = fragment_size_;
         }
         
-        if (sent) {
-            messages_sent_success_++;
-            LOG_DEBUG("队列消息发送成功: " + queued_msg.data);
+        bool is_binary = message.type == MessageType::BINARY;
+        if (datalink_->sendFragmented(message.data.data(), message.data.size(), is_binary, fragment_size)) {
+            send_latency_.recordSince(message.accepted_ns);
+            stats_.add(STAT_SENT_SUCCESS);
+            LOG_DEBUGF("调度消息发送成功，优先级: {}，大小: {} 字节",
+                       static_cast<int>(message.priority), message.data.size());
+            if (!is_binary && send_success_callback_) {
+                send_success_callback_(message.data.str());
+            }
+            if (message.completion) {
+                message.completion(true, "");
+            }
         } else {
-            messages_sent_failed_++;
-            LOG_ERROR("队列消息发送失败: " + queued_msg.data);
-            break;  // 发送失败，停止处理队列
+            stats_.add(STAT_SENT_FAILED);
+            LOG_ERROR("调度消息发送失败，大小: " + std::to_string(message.data.size()) + " 字节");
+            if (!is_binary && send_failure_callback_) {
+                send_failure_callback_(message.data.str(), "发送失败");
+            }
+            if (message.completion) {
+                message.completion(false, "发送失败");
+            }
+        }
+    }
+}
+
+bool WebSocketManager::enableReliableDelivery(bool enabled, const ReliableChannelOptions& options) {
+    if (!enabled) {
+        std::shared_ptr<ReliableChannel> previous =
+            std::atomic_exchange(&reliable_channel_, std::shared_ptr<ReliableChannel>());
+        if (previous) {
+            previous->failAll("可靠投递已禁用");
+            LOG_INFO("禁用可靠投递");
         }
+        return true;
+    }
+    
+    if (!datalink_) {
+        LOG_ERROR("数据链路层未初始化");
+        return false;
+    }
+    
+    // 旧通道在最后一个使用者释放后析构，析构时通知其未完成的消息失败
+    std::atomic_store(&reliable_channel_, std::shared_ptr<ReliableChannel>(
+        new ReliableChannel(*datalink_, logger_, options)));
+    LOG_INFO("启用可靠投递，窗口大小: " + std::to_string(options.window_size) +
+             "，待发送上限: " + std::to_string(options.max_pending));
+    return true;
+}
+
+void WebSocketManager::processMessageQueue() {
+    if (!queue_enabled_ || !isConnected()) {
+        return;
+    }
+    
+    startDrain();
+}
+
+WebSocketManager::DrainResult WebSocketManager::drainBatch(uint64_t& wait_ns) {
+    DrainResult result = DrainResult::BATCH_DONE;
+    wait_ns = 0;
+    size_t sent_count = 0;
+    
+    while (sent_count < drain_batch_size_) {
+        QueuedMessage message;
+        bool expired = false;
         
-        message_queue_.pop();
+        // 每条消息单独加锁，且只在取出时持锁：写入传输层期间生产者和阻塞等待的入队方不被阻塞
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            
+            if (message_queue_.empty()) {
+                result = DrainResult::EMPTY;
+                break;
+            }
+            
+            QueuedMessage& queued_msg = *message_queue_.front();
+            
+            // 出队时惰性丢弃过期消息，不占用令牌
+            if (queued_msg.isExpired(platform_->getCurrentTimestamp())) {
+                if (persistent_log_) {
+                    persistent_log_->markConsumed(queued_msg.log_position);
+                }
+                stats_.add(STAT_EXPIRED);
+                LOG_DEBUG("队列消息已过期，丢弃，大小: " + std::to_string(queued_msg.data.size()) + " 字节");
+                expired = true;
+            } else {
+                if (!drain_bucket_.tryAcquire()) {
+                    wait_ns = drain_bucket_.waitNanos();
+                    result = DrainResult::THROTTLED;
+                    break;
+                }
+                
+                // 积压消息同样受出站速率限制
+                if (!rate_limiter_.tryAcquire(queued_msg.priority, queued_msg.data.size())) {
+                    drain_bucket_.refund();
+                    wait_ns = rate_limiter_.waitNanos(queued_msg.priority, queued_msg.data.size());
+                    result = DrainResult::THROTTLED;
+                    break;
+                }
+            }
+            message_queue_.pop(message);
+        }
+        
+        if (!expired) {
+            // 负载直接从内存池缓冲区写入传输层
+            bool sent = datalink_->sendData(message.data.data(), message.data.size(),
+                                            message.type == MessageType::BINARY);
+            
+            if (!sent) {
+                stats_.add(STAT_SENT_FAILED);
+                LOG_ERROR("队列消息发送失败，大小: " + std::to_string(message.data.size()) + " 字节");
+                requeueMessage(message);
+                result = DrainResult::SEND_FAILED;
+                break;  // 发送失败，消息放回队首待重试
+            }
+            
+            // 从持久化队列回放的消息没有接受时刻，不计入
+            queue_wait_latency_.recordSince(message.accepted_ns);
+            if (message.log_position != SegmentLog::kInvalidPosition) {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                if (persistent_log_) {
+                    persistent_log_->markConsumed(message.log_position);
+                }
+            }
+            stats_.add(STAT_SENT_SUCCESS);
+            LOG_DEBUGF("队列消息发送成功，大小: {} 字节", message.data.size());
+            sent_count++;
+        }
+        
+        // 队列已腾出空间，唤醒阻塞等待的生产者
+        queue_space_cv_.notify_all();
+        
+        if (message.completion) {
+            if (expired) {
+                message.completion(false, "消息已过期");
+            } else {
+                message.completion(true, "");
+            }
+        }
+    }
+    
+    return result;
+}
+
+void WebSocketManager::requeueMessage(QueuedMessage& message) {
+    bool requeued = false;
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        // 发送期间队列已被禁用或清空时不再放回
+        if (queue_enabled_) {
+            requeued = message_queue_.pushFront(message);
+        }
+        if (!requeued && persistent_log_) {
+            persistent_log_->markConsumed(message.log_position);
+        }
+    }
+    
+    if (requeued) {
+        return;
+    }
+    
+    const char* reason = queue_enabled_ ? "已被同键新消息替换" : "队列已清空";
+    if (queue_enabled_) {
+        stats_.add(STAT_COALESCED);
+    }
+    if (message.completion) {
+        message.completion(false, reason);
+    }
+}
+
+void WebSocketManager::startDrain() {
+    if (drain_running_) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    if (drain_running_) {
+        return;
+    }
+    
+    // 回收上一次已自行退出的排空线程
+    if (drain_thread_) {
+        platform_->joinThread(drain_thread_);
+        drain_thread_ = nullptr;
+    }
+    
+    drain_running_ = true;
+    drain_thread_ = platform_->createThread(drainThread, this);
+    if (!drain_thread_) {
+        drain_running_ = false;
+        LOG_ERROR("创建队列排空线程失败");
+    }
+}
+
+void WebSocketManager::stopDrain() {
+    void* thread = nullptr;
+    
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        drain_running_ = false;
+        thread = drain_thread_;
+        drain_thread_ = nullptr;
+    }
+    
+    if (thread) {
+        platform_->joinThread(thread);
+    }
+}
+
+void WebSocketManager::drainThread(void* arg) {
+    WebSocketManager* manager = static_cast<WebSocketManager*>(arg);
+    manager->performDrain();
+}
+
+void WebSocketManager::performDrain() {
+    LOG_DEBUG("开始排空消息队列，积压消息数: " + std::to_string(getQueuedMessageCount()));
+    
+    int retry_wait_ms = 0;
+    while (true) {
+        uint64_t wait_ns = 0;
+        bool connected = isConnected();
+        DrainResult result = connected ? drainBatch(wait_ns) : DrainResult::SEND_FAILED;
+        
+        if (result == DrainResult::SEND_FAILED && connected) {
+            // 连接仍在时按指数退避重试，排空线程保持运行，新消息继续排在积压之后
+            retry_wait_ms = std::min(retry_wait_ms == 0 ? kMinDrainRetryMs : retry_wait_ms * 2,
+                                     kMaxDrainWaitMs);
+            platform_->sleep(retry_wait_ms);
+        } else if (result == DrainResult::THROTTLED) {
+            uint64_t wait_ms = wait_ns / 1000000;
+            platform_->sleep(static_cast<int>(std::min<uint64_t>(std::max<uint64_t>(wait_ms, 1),
+                                                                 kMaxDrainWaitMs)));
+        } else if (result == DrainResult::BATCH_DONE) {
+            // 批间让出，给生产者和其他发送方机会
+            platform_->sleep(0);
+        }
+        
+        // 退出判断与 startDrain 互斥，保证退出后新入队的消息会重新启动排空
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        if (!drain_running_) {
+            return;
+        }
+        
+        if (result != DrainResult::SEND_FAILED) {
+            retry_wait_ms = 0;
+        }
+        
+        if ((result == DrainResult::SEND_FAILED && !isConnected()) ||
+            (result == DrainResult::EMPTY && getQueuedMessageCount() == 0)) {
+            drain_running_ = false;
+            LOG_DEBUG("消息队列排空结束");
+            return;
+        }
     }
 }
 
@@ -249,14 +1034,38 @@ size_t WebSocketManager::getQueuedMessageCount() const {
     return message_queue_.size();
 }
 
-void WebSocketManager::clearMessageQueue() {
+size_t WebSocketManager::getQueuedBytes() const {
     std::lock_guard<std::mutex> lock(queue_mutex_);
-    while (!message_queue_.empty()) {
-        message_queue_.pop();
-    }
+    return message_queue_.bytes();
+}
+
+void WebSocketManager::clearMessageQueue() {
+    failQueuedMessages("队列已清空");
     LOG_INFO("消息队列已清空");
 }
 
+void WebSocketManager::failQueuedMessages(const std::string& reason) {
+    std::vector<SendCompletionCallback> pending;
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        QueuedMessage queued_msg;
+        while (message_queue_.pop(queued_msg)) {
+            if (persistent_log_) {
+                persistent_log_->markConsumed(queued_msg.log_position);
+            }
+            if (queued_msg.completion) {
+                pending.push_back(std::move(queued_msg.completion));
+            }
+        }
+    }
+    queue_space_cv_.notify_all();
+    
+    for (const auto& completion : pending) {
+        completion(false, reason);
+    }
+}
+
 void WebSocketManager::setHeartbeatInterval(int interval_ms) {
     heartbeat_interval_ms_ = interval_ms;
     LOG_INFO("设置心跳间隔: " + std::to_string(interval_ms) + "ms");
@@ -288,12 +1097,53 @@ std::string WebSocketManager::getStatistics() const {
     }
     
     oss << "\n";
-    oss << "  发送成功消息数: " << messages_sent_success_ << "\n";
-    oss << "  发送失败消息数: " << messages_sent_failed_ << "\n";
-    oss << "  接收消息数: " << messages_received_ << "\n";
-    oss << "  队列消息数: " << getQueuedMessageCount() << "\n";
+    WebSocketStats stats = getStats();
+    oss << "  发送成功消息数: " << stats.messages_sent << "\n";
+    oss << "  发送失败消息数: " << stats.messages_failed << "\n";
+    oss << "  接收消息数: " << stats.messages_received << "\n";
+    oss << "  队列消息数: " << stats.queued_messages << "\n";
+    oss << "  队列字节数: " << stats.queued_bytes << "\n";
+    oss << "  队列溢出丢弃数: " << stats.messages_evicted << "\n";
+    oss << "  队列过期丢弃数: " << stats.messages_expired << "\n";
+    oss << "  队列合并替换数: " << stats.messages_coalesced << "\n";
+    oss << "  限速节流数: " << stats.messages_throttled << "\n";
+    oss << "  调度队列消息数: " << stats.scheduled_messages << "\n";
     oss << "  心跳状态: " << (heartbeat_enabled_ ? "启用" : "禁用") << "\n";
     
+    BufferPoolStats pool = BufferPool::instance().getStats();
+    oss << "  缓冲池分配次数: " << pool.allocations << "\n";
+    oss << "  缓冲池线程缓存命中数: " << pool.thread_cache_hits << "\n";
+    oss << "  缓冲池系统分配次数: " << pool.system_allocations << "\n";
+    oss << "  缓冲池使用字节数: " << pool.bytes_in_use << "\n";
+    oss << "  缓冲池缓存字节数: " << pool.bytes_cached << "\n";
+    
+    static const char* const kLatencyNames[kLatencyMetricCount] = {
+        "连接握手耗时", "连接建立总耗时", "发送延迟", "队列等待时间", "Ping 往返时间"
+    };
+    for (size_t i = 0; i < kLatencyMetricCount; ++i) {
+        LatencyStats latency = getLatencySnapshot(static_cast<LatencyMetric>(i)).stats();
+        if (latency.count > 0) {
+            oss << "  " << kLatencyNames[i] << "(us): 次数 " << latency.count
+                << "，p50 " << latency.p50_ns / 1000
+                << "，p99 " << latency.p99_ns / 1000
+                << "，p999 " << latency.p999_ns / 1000
+                << "，最大 " << latency.max_ns / 1000 << "\n";
+        }
+    }
+    
+    if (logger_ && logger_->isAsync()) {
+        oss << "  日志丢弃数: " << stats.log_dropped << "\n";
+    }
+    if (stats.log_suppressed > 0) {
+        oss << "  日志抑制数: " << stats.log_suppressed << "\n";
+    }
+    
+    if (std::atomic_load(&reliable_channel_)) {
+        oss << "  可靠通道未确认数: " << stats.reliable.in_flight << "\n";
+        oss << "  可靠通道待发送数: " << stats.reliable.pending << "\n";
+        oss << "  可靠通道重传数: " << stats.reliable.retransmits << "\n";
+    }
+    
     if (datalink_) {
         oss << "\n" << datalink_->getStatistics();
     }
@@ -301,6 +1151,65 @@ std::string WebSocketManager::getStatistics() const {
     return oss.str();
 }
 
+WebSocketStats WebSocketManager::getStats() const {
+    WebSocketStats stats = WebSocketStats();
+    stats.connection_state = getConnectionState();
+    stats.messages_sent = stats_.get(STAT_SENT_SUCCESS);
+    stats.messages_failed = stats_.get(STAT_SENT_FAILED);
+    stats.messages_received = stats_.get(STAT_RECEIVED);
+    stats.messages_evicted = stats_.get(STAT_EVICTED);
+    stats.messages_expired = stats_.get(STAT_EXPIRED);
+    stats.messages_coalesced = stats_.get(STAT_COALESCED);
+    stats.messages_throttled = stats_.get(STAT_THROTTLED);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stats.queued_messages = message_queue_.size();
+        stats.queued_bytes = message_queue_.bytes();
+    }
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        stats.scheduled_messages = scheduler_.size();
+    }
+    if (logger_) {
+        stats.log_dropped = logger_->getDroppedCount();
+        stats.log_suppressed = logger_->getSuppressedCount();
+    }
+    if (datalink_) {
+        stats.link = datalink_->getStats();
+    }
+    std::shared_ptr<ReliableChannel> reliable = std::atomic_load(&reliable_channel_);
+    if (reliable) {
+        stats.reliable = reliable->getStats();
+    }
+    return stats;
+}
+
+LatencySnapshot WebSocketManager::getLatencySnapshot(LatencyMetric metric) const {
+    switch (metric) {
+        case LatencyMetric::SEND: return send_latency_.snapshot();
+        case LatencyMetric::QUEUE_WAIT: return queue_wait_latency_.snapshot();
+        default: return datalink_ ? datalink_->getLatencySnapshot(metric) : LatencySnapshot();
+    }
+}
+
+void WebSocketManager::resetLatencyHistograms() {
+    send_latency_.reset();
+    queue_wait_latency_.reset();
+    if (datalink_) {
+        datalink_->resetLatencyHistograms();
+    }
+}
+
+void WebSocketManager::enableLatencyTracking(bool enabled) {
+    latency_tracking_ = enabled;
+    send_latency_.setEnabled(enabled);
+    queue_wait_latency_.setEnabled(enabled);
+    if (datalink_) {
+        datalink_->enableLatencyTracking(enabled);
+    }
+    LOG_INFO(std::string(enabled ? "启用" : "禁用") + "延迟记录");
+}
+
 void WebSocketManager::setConfig(const std::string& key, const std::string& value) {
     if (platform_) {
         platform_->setConfig(key, value);
@@ -315,7 +1224,13 @@ void WebSocketManager::onConnectionStateChanged(ConnectionState state) {
     LOG_INFO("连接状态变化: " + std::to_string(static_cast<int>(state)));
     
     if (state == ConnectionState::CONNECTED) {
-        // 连接成功后处理消息队列
+        // 先重放可靠通道中未确认的消息
+        std::shared_ptr<ReliableChannel> reliable = std::atomic_load(&reliable_channel_);
+        if (reliable) {
+            reliable->onConnected();
+        }
+        
+        // 连接成功后在后台增量排空消息队列
         processMessageQueue();
     }
     
@@ -325,8 +1240,14 @@ void WebSocketManager::onConnectionStateChanged(ConnectionState state) {
 }
 
 void WebSocketManager::onMessageReceived(const WebSocketMessage& message) {
-    messages_received_++;
-    LOG_DEBUG("接收消息: " + message.data);
+    // 确认帧由可靠通道处理，不交给上层
+    std::shared_ptr<ReliableChannel> reliable = std::atomic_load(&reliable_channel_);
+    if (reliable && reliable->handleIncoming(message.data.data(), message.data.size())) {
+        return;
+    }
+    
+    stats_.add(STAT_RECEIVED);
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "接收消息: " + message.data.str());
     
     if (message_callback_) {
         message_callback_(message);
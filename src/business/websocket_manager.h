@@ -1,43 +1,44 @@
 #pragma once
 
+#include "message_queue.h"
+#include "send_rate_limiter.h"
+#include "fair_scheduler.h"
 #include "../core/datalink/datalink.h"
+#include "../core/datalink/reliable_channel.h"
 #include "../core/logger/logger.h"
+#include "../core/metrics/latency_histogram.h"
+#include "../core/metrics/sharded_counter.h"
+#include "../core/ratelimit/token_bucket.h"
 #include "../platform/platform_interface.h"
 #include <string>
 #include <memory>
 #include <functional>
 #include <map>
-#include <queue>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 namespace cross_platform_websocket {
 
 /**
- * @brief 消息优先级枚举
+ * @brief WebSocket 管理器统计信息（POD，可直接按值复制）
  */
-enum class MessagePriority {
-    LOW = 0,
-    NORMAL = 1,
-    HIGH = 2,
-    URGENT = 3
-};
-
-/**
- * @brief 消息队列项
- */
-struct QueuedMessage {
-    std::string data;
-    MessageType type;
-    MessagePriority priority;
-    uint64_t timestamp;
-    
-    QueuedMessage(const std::string& d, MessageType t, MessagePriority p)
-        : data(d), type(t), priority(p), timestamp(0) {}
-    
-    // 用于优先级队列的比较
-    bool operator<(const QueuedMessage& other) const {
-        return static_cast<int>(priority) < static_cast<int>(other.priority);
-    }
+struct WebSocketStats {
+    ConnectionState connection_state;
+    uint64_t messages_sent;         // 发送成功消息数
+    uint64_t messages_failed;       // 发送失败消息数
+    uint64_t messages_received;     // 交给上层的接收消息数
+    uint64_t queued_messages;       // 队列消息数
+    uint64_t queued_bytes;          // 队列字节数
+    uint64_t messages_evicted;      // 队列溢出丢弃数
+    uint64_t messages_expired;      // 队列过期丢弃数
+    uint64_t messages_coalesced;    // 队列合并替换数
+    uint64_t messages_throttled;    // 限速节流数
+    uint64_t scheduled_messages;    // 公平调度队列消息数
+    uint64_t log_dropped;           // 异步日志丢弃数
+    uint64_t log_suppressed;        // 采样/限速抑制的日志行数
+    DataLinkStats link;             // 数据链路层计数
+    ReliableChannelStats reliable;  // 可靠通道计数（未启用时为 0）
 };
 
 /**
@@ -87,6 +88,45 @@ public:
      */
     bool sendText(const std::string& message, MessagePriority priority = MessagePriority::NORMAL);
     
+    /**
+     * @brief 发送文本消息，并在写入完成时回调
+     * @param message 消息内容
+     * @param priority 消息优先级
+     * @param completion 完成回调（消息写入传输层或最终失败时调用）
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendText(const std::string& message, MessagePriority priority,
+                  SendCompletionCallback completion);
+    
+    /**
+     * @brief 发送文本消息并转移负载所有权
+     * 
+     * 入队或交给调度线程时直接转移缓冲区，整个发送过程不复制负载。
+     * 
+     * @param message 消息内容（调用后为空）
+     * @param priority 消息优先级
+     * @param completion 完成回调
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendText(Payload&& message, MessagePriority priority = MessagePriority::NORMAL,
+                  SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 发送带合并键的文本消息
+     * 
+     * 已连接时直接发送；离线入队且启用了按键合并时，若队列中已有同键消息，
+     * 则原地替换其内容并保留原有队列位置，被替换消息的完成回调以失败结果调用。
+     * 
+     * @param key 合并键（空键不参与合并）
+     * @param message 消息内容
+     * @param priority 消息优先级
+     * @param completion 完成回调
+     * @return 消息是否被接受（已发送、已加入队列或已替换同键消息）
+     */
+    bool sendKeyedText(const std::string& key, const std::string& message,
+                       MessagePriority priority = MessagePriority::NORMAL,
+                       SendCompletionCallback completion = SendCompletionCallback());
+    
     /**
      * @brief 发送二进制消息
      * @param data 二进制数据
@@ -95,6 +135,57 @@ public:
      */
     bool sendBinary(const std::vector<uint8_t>& data, MessagePriority priority = MessagePriority::NORMAL);
     
+    /**
+     * @brief 发送二进制消息，并在写入完成时回调
+     * @param data 二进制数据
+     * @param priority 消息优先级
+     * @param completion 完成回调（消息写入传输层或最终失败时调用）
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendBinary(const std::vector<uint8_t>& data, MessagePriority priority,
+                    SendCompletionCallback completion);
+    
+    /**
+     * @brief 发送一段连续内存中的二进制消息
+     * 
+     * 直接发送时不复制数据；入队或交给调度线程时复制一次到内存池缓冲区。
+     * 
+     * @param data 二进制数据指针
+     * @param length 字节数
+     * @param priority 消息优先级
+     * @param completion 完成回调
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendBinary(const uint8_t* data, size_t length,
+                    MessagePriority priority = MessagePriority::NORMAL,
+                    SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 发送二进制消息并转移负载所有权
+     * @param data 二进制数据（调用后为空）
+     * @param priority 消息优先级
+     * @param completion 完成回调
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendBinary(Payload&& data, MessagePriority priority = MessagePriority::NORMAL,
+                    SendCompletionCallback completion = SendCompletionCallback());
+    
+    /**
+     * @brief 发送共享负载
+     * 
+     * 负载只存储一份，入队和调度时只持有引用，同一负载可同时提交给多个连接，
+     * 各连接只在写入时各自组帧和加掩码。
+     * 
+     * @param payload 共享负载
+     * @param type 消息类型（TEXT 或 BINARY）
+     * @param priority 消息优先级
+     * @param completion 完成回调
+     * @return 消息是否被接受（已发送或已加入队列）
+     */
+    bool sendShared(const SharedPayload& payload, MessageType type,
+                    MessagePriority priority = MessagePriority::NORMAL,
+                    SendCompletionCallback completion = SendCompletionCallback());
+    
     /**
      * @brief 发送 Ping 消息
      * @return 是否发送成功
@@ -151,7 +242,132 @@ public:
     void enableMessageQueue(bool enabled, size_t max_queue_size = 1000);
     
     /**
-     * @brief 处理消息队列
+     * @brief 设置消息队列的字节上限和溢出策略
+     * 
+     * 字节上限按消息负载大小累计，与 enableMessageQueue 的条数上限同时生效。
+     * 
+     * @param max_queue_bytes 队列最大字节数
+     * @param policy 队列满时的处理策略
+     * @param block_timeout_ms BLOCK 策略下的最长等待时间（毫秒）
+     */
+    void setMessageQueueLimits(size_t max_queue_bytes,
+                               QueueOverflowPolicy policy = QueueOverflowPolicy::REJECT_NEWEST,
+                               int block_timeout_ms = 0);
+    
+    /**
+     * @brief 启用或禁用队列消息按键合并（后写入的同键消息替换先入队的消息）
+     * 
+     * 启用后离线积压的消息数受不同键的数量约束，而不是更新频率。
+     * 
+     * @param enabled 是否启用
+     */
+    void enableMessageCoalescing(bool enabled);
+    
+    /**
+     * @brief 设置指定优先级队列消息的存活时间
+     * 
+     * 过期消息不做周期扫描，在出队发送时惰性丢弃并计数，其完成回调以失败结果调用。
+     * 
+     * @param priority 消息优先级
+     * @param ttl_ms 存活时间（毫秒），0 表示永不过期
+     */
+    void setMessageTTL(MessagePriority priority, uint64_t ttl_ms);
+    
+    /**
+     * @brief 启用持久化消息队列
+     * 
+     * 入队消息同时顺序追加到内存映射的段文件中，发送成功、被淘汰或队列被清空后
+     * 标记为已消费，段内消息全部消费后段文件被回收复用。启用时回放上次进程
+     * 退出前未发送的消息，按优先级重新入队，回放同样受队列条数、字节上限和溢出策略约束
+     * （BLOCK 策略不等待，超出部分丢弃）。需同时通过 enableMessageQueue 启用队列。
+     * 
+     * 已启用时再次调用直接返回。关闭后重新启用时，队列中来自已关闭日志的消息先被移除，
+     * 其完成回调以失败通知，随后由回放重新入队。
+     * 
+     * @param options 段日志配置（目录、段大小、段数上限、同步批量）
+     * @return 是否成功
+     */
+    bool enablePersistentQueue(const SegmentLogOptions& options);
+    
+    /**
+     * @brief 关闭持久化队列（未发送的消息保留在磁盘上，下次启用时回放）
+     */
+    void disablePersistentQueue();
+    
+    /**
+     * @brief 设置重连后队列排空的速率
+     * 
+     * 积压消息由后台排空线程按批发送：每批最多 batch_size 条，批间释放队列锁并让出，
+     * 发送速率受令牌桶限制。排空期间新的非紧急消息排在积压之后以保持顺序，
+     * URGENT 消息直接发送。
+     * 
+     * @param messages_per_second 每秒最多发送的积压消息数，0 表示不限速
+     * @param batch_size 每批最多发送的消息数（同时作为令牌桶的突发容量）
+     */
+    void setQueueDrainRate(double messages_per_second, size_t batch_size = 64);
+    
+    /**
+     * @brief 设置连接级出站速率限制（消息数/秒和字节数/秒）
+     * @param options 速率限制配置
+     */
+    void setRateLimit(const RateLimitOptions& options);
+    
+    /**
+     * @brief 设置指定优先级的出站速率限制，与连接级限制同时生效
+     * @param priority 消息优先级
+     * @param options 速率限制配置
+     */
+    void setPriorityRateLimit(MessagePriority priority, const RateLimitOptions& options);
+    
+    /**
+     * @brief 设置超出速率时的处理方式
+     * @param action 加入队列补发或直接拒绝
+     */
+    void setRateLimitAction(RateLimitAction action);
+    
+    /**
+     * @brief 获取因超出速率而被节流（入队或拒绝）的发送次数
+     * @return 节流次数
+     */
+    uint64_t getThrottledMessageCount() const;
+    
+    /**
+     * @brief 启用或禁用已连接时的加权公平发送调度
+     * 
+     * 启用后已连接时的发送不再直接写入传输层，而是进入按优先级分道的调度队列，
+     * 由发送线程按权重赤字轮转取出写入；超过分片大小的消息以 continuation 帧
+     * 逐片写入，片间可插入 Ping 等控制帧。完成回调在发送线程中调用。
+     * 禁用时等待已调度的消息发送完毕。
+     * 
+     * @param enabled 是否启用
+     * @param fragment_size 分片大小（字节，同时作为每单位权重每轮的字节额度），0 表示不分片
+     */
+    void enableFairScheduling(bool enabled, size_t fragment_size = 16 * 1024);
+    
+    /**
+     * @brief 设置公平调度中指定优先级的权重（默认 LOW 1、NORMAL 2、HIGH 4、URGENT 8）
+     * @param priority 消息优先级
+     * @param weight 权重
+     */
+    void setPriorityWeight(MessagePriority priority, uint32_t weight);
+    
+    /**
+     * @brief 启用或禁用至少一次投递
+     * 
+     * 启用后所有文本和二进制消息经可靠通道发送：分配序号、保留在重传缓冲区直到
+     * 服务器累积确认，重连后重放未确认的消息。完成回调在收到确认时调用。
+     * 此模式下消息由通道缓存（含离线期间），不经过离线队列、限速和公平调度。
+     * 需在 initialize 之后调用；禁用时未确认的消息以失败结果完成。
+     * 
+     * @param enabled 是否启用
+     * @param options 窗口配置
+     * @return 是否成功
+     */
+    bool enableReliableDelivery(bool enabled,
+                                const ReliableChannelOptions& options = ReliableChannelOptions());
+    
+    /**
+     * @brief 处理消息队列（已连接时启动后台增量排空，立即返回）
      */
     void processMessageQueue();
     
@@ -161,6 +377,12 @@ public:
      */
     size_t getQueuedMessageCount() const;
     
+    /**
+     * @brief 获取队列中消息负载的总字节数
+     * @return 字节数
+     */
+    size_t getQueuedBytes() const;
+    
     /**
      * @brief 清空消息队列
      */
@@ -184,6 +406,41 @@ public:
      */
     std::string getStatistics() const;
     
+    /**
+     * @brief 获取统计计数
+     * 
+     * 不分配内存、不构造字符串，只短暂获取队列锁读取队列长度，适合高频轮询大量连接。
+     * 
+     * @return 统计信息
+     */
+    WebSocketStats getStats() const;
+    
+    /**
+     * @brief 获取延迟指标的直方图副本
+     * 
+     * 副本可与其他连接的同一指标合并（LatencySnapshot::merge）后再计算分位数。
+     * 
+     * @param metric 延迟指标
+     * @return 副本
+     */
+    LatencySnapshot getLatencySnapshot(LatencyMetric metric) const;
+    
+    /**
+     * @brief 清空所有延迟直方图
+     */
+    void resetLatencyHistograms();
+    
+    /**
+     * @brief 启用或禁用延迟记录（默认启用）
+     * 
+     * 每个连接有 5 个延迟直方图，桶数组在各指标第一次记录时分配，全部用到时约 40KB
+     * （发送、握手和 Ping 往返各约 7.5KB，总连接耗时和队列等待各约 9KB）。
+     * 大量连接只需汇总计数时，可在连接前禁用以免分配；禁用后已分配的桶数组保留到连接销毁。
+     * 
+     * @param enabled 是否启用
+     */
+    void enableLatencyTracking(bool enabled);
+    
     /**
      * @brief 设置配置
      * @param key 配置键
@@ -199,15 +456,49 @@ public:
     std::string getConfig(const std::string& key) const;
 
 private:
+    /**
+     * @brief 日志宏使用的上下文：写入本实例的日志器，按 MANAGER 模块的级别过滤
+     */
+    LogContext wsLogContext(LogContextTag) const {
+        return LogContext(logger_.get(), LogModule::MANAGER);
+    }
+    
     std::shared_ptr<PlatformInterface> platform_;
     std::shared_ptr<Logger> logger_;
     std::unique_ptr<DataLink> datalink_;
+    // 启用/禁用可能与发送、接收线程并发，用 atomic_load/atomic_store 访问，每次使用前取一份本地副本
+    std::shared_ptr<ReliableChannel> reliable_channel_;
     
     // 消息队列相关
-    std::priority_queue<QueuedMessage> message_queue_;
+    MessageQueue message_queue_;
     mutable std::mutex queue_mutex_;
     bool queue_enabled_;
     size_t max_queue_size_;
+    size_t max_queue_bytes_;
+    QueueOverflowPolicy overflow_policy_;
+    int block_timeout_ms_;
+    std::condition_variable queue_space_cv_;
+    std::unique_ptr<SegmentLog> persistent_log_;
+    uint64_t message_ttl_ms_[MessageQueue::kPriorityLevels];
+    
+    // 出站限速相关
+    SendRateLimiter rate_limiter_;
+    RateLimitAction rate_limit_action_;
+    
+    // 公平调度相关
+    FairScheduler scheduler_;
+    mutable std::mutex scheduler_mutex_;
+    std::condition_variable scheduler_cv_;
+    size_t fragment_size_;
+    void* scheduler_thread_;
+    std::atomic<bool> scheduler_thread_running_;
+    
+    // 队列排空相关
+    TokenBucket drain_bucket_;
+    size_t drain_batch_size_;
+    std::mutex drain_mutex_;
+    void* drain_thread_;
+    std::atomic<bool> drain_running_;
     
     // 心跳相关
     bool heartbeat_enabled_;
@@ -222,10 +513,23 @@ private:
     std::function<void(const std::string&)> send_success_callback_;
     std::function<void(const std::string&, const std::string&)> send_failure_callback_;
     
-    // 统计信息
-    uint64_t messages_sent_success_;
-    uint64_t messages_sent_failed_;
-    uint64_t messages_received_;
+    // 统计信息（调用方线程、排空线程和发送线程都会更新，按线程分片计数）
+    enum StatCounter {
+        STAT_SENT_SUCCESS,
+        STAT_SENT_FAILED,
+        STAT_RECEIVED,
+        STAT_EVICTED,
+        STAT_EXPIRED,
+        STAT_COALESCED,
+        STAT_THROTTLED,
+        STAT_COUNT
+    };
+    ShardedCounters<STAT_COUNT> stats_;
+    
+    // 延迟统计（连接和 Ping 往返由数据链路层记录）
+    LatencyHistogram send_latency_;
+    LatencyHistogram queue_wait_latency_;
+    bool latency_tracking_;  // 数据链路层在 initialize 中创建，创建时按此设置
     
     // 内部方法
     void onConnectionStateChanged(ConnectionState state);
@@ -234,6 +538,140 @@ private:
     void startHeartbeat();
     void stopHeartbeat();
     
+    /**
+     * @brief 发送消息（离线时按需入队或合并）
+     * @param key 合并键（可为空）
+     * @param data 消息数据
+     * @param size 消息字节数
+     * @param body 持有 data 的负载（非空时入队和调度直接转移它，否则复制 data）
+     * @param type 消息类型
+     * @param priority 消息优先级
+     * @param completion 完成回调
+     * @return 消息是否被接受
+     */
+    bool sendMessage(const std::string& key, const char* data, size_t size,
+                     Payload* body, MessageType type,
+                     MessagePriority priority, SendCompletionCallback completion);
+    
+    /**
+     * @brief 经可靠通道发送消息
+     * @param channel 可靠通道
+     * @param data 消息数据
+     * @param size 消息字节数
+     * @param type 消息类型
+     * @param completion 完成回调（收到确认时调用）
+     * @return 消息是否被接受
+     */
+    bool sendReliable(ReliableChannel& channel, const char* data, size_t size, MessageType type,
+                      SendCompletionCallback completion);
+    
+    /**
+     * @brief 按容量限制和溢出策略将消息加入队列
+     * @param message 待入队消息（仅在入队成功时被移走）
+     * @param reason 失败原因
+     * @return 是否入队成功
+     */
+    bool enqueueMessage(QueuedMessage&& message, std::string& reason);
+    
+    /**
+     * @brief 按所属优先级的存活时间设置消息过期时间（调用时需持有 queue_mutex_）
+     * @param message 队列消息
+     */
+    void applyMessageTTL(QueuedMessage& message) const;
+    
+    /**
+     * @brief 按溢出策略为新消息腾出队列空间（调用时需持有 queue_mutex_）
+     * @param lock 队列锁，BLOCK 策略下在等待时释放
+     * @param priority 新消息优先级
+     * @param bytes 新消息字节数
+     * @param evicted 被淘汰的消息
+     * @param reason 失败原因
+     * @param may_block 为 false 时 BLOCK 策略不等待，按队列已满处理（持久化回放时使用）
+     * @return 是否有足够空间
+     */
+    bool makeQueueSpace(std::unique_lock<std::mutex>& lock, MessagePriority priority,
+                        size_t bytes, std::vector<QueuedMessage>& evicted, std::string& reason,
+                        bool may_block = true);
+    
+    /**
+     * @brief 统计并通知因队列溢出被淘汰的消息（在锁外调用）
+     * @param evicted 被淘汰的消息
+     */
+    void notifyEvicted(std::vector<QueuedMessage>& evicted);
+    
+    /**
+     * @brief 以失败结果完成队列中所有消息并清空队列
+     * @param reason 失败原因
+     */
+    void failQueuedMessages(const std::string& reason);
+    
+    /**
+     * @brief 将已连接时的发送交给公平调度
+     * @param message 待发送消息（仅在调度成功时被移走）
+     * @return 调度未启用时返回 false，由调用方直接发送
+     */
+    bool scheduleMessage(QueuedMessage&& message);
+    
+    /**
+     * @brief 停止发送线程（等待已调度的消息发送完毕）
+     */
+    void stopScheduler();
+    
+    /**
+     * @brief 发送线程函数
+     * @param arg 线程参数
+     */
+    static void schedulerThread(void* arg);
+    
+    /**
+     * @brief 执行调度发送
+     */
+    void performScheduledSends();
+    
+    /**
+     * @brief 一批排空的结果
+     */
+    enum class DrainResult {
+        EMPTY,          // 队列已空
+        BATCH_DONE,     // 本批已发满，队列中还有消息
+        THROTTLED,      // 令牌不足，等待补充
+        SEND_FAILED     // 发送失败（仍连接时退避重试，已断开时停止排空）
+    };
+    
+    /**
+     * @brief 发送一批积压消息（每条消息单独加锁，完成回调在锁外调用）
+     * @param wait_ns 限速时建议的等待时间（纳秒）
+     * @return 本批结果
+     */
+    DrainResult drainBatch(uint64_t& wait_ns);
+    
+    /**
+     * @brief 把发送失败的积压消息放回队首；已有同键新消息或队列已禁用时通知其失败
+     * @param message 消息
+     */
+    void requeueMessage(QueuedMessage& message);
+    
+    /**
+     * @brief 启动排空线程（已在运行时直接返回）
+     */
+    void startDrain();
+    
+    /**
+     * @brief 停止排空线程并等待其退出
+     */
+    void stopDrain();
+    
+    /**
+     * @brief 排空线程函数
+     * @param arg 线程参数
+     */
+    static void drainThread(void* arg);
+    
+    /**
+     * @brief 执行排空
+     */
+    void performDrain();
+    
     /**
      * @brief 心跳线程函数
      * @param arg 线程参数
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 有界无锁多生产者单消费者环形队列
+ * 
+ * 每个槽位带一个序号（Vyukov 有界队列）：生产者用 CAS 领取写入位置，
+ * 写完后发布序号；消费者只有一个，按序号判断槽位是否可读，无需 CAS。
+ * 容量固定为 2 的幂，队列满时 tryPush 立即返回 false，由调用方决定丢弃或重试。
+ */
+template <typename T>
+class MpscRing {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量（向上取整为 2 的幂，至少为 2）
+     */
+    explicit MpscRing(size_t capacity)
+        : mask_(0)
+        , enqueue_pos_(0)
+        , dequeue_pos_(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        
+        cells_ = std::unique_ptr<Cell[]>(new Cell[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask_ = rounded - 1;
+    }
+    
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+    
+    /**
+     * @brief 尝试写入一个元素（可由多个线程同时调用）
+     * @param value 元素（仅在写入成功时被移走）
+     * @return 是否写入成功（队列满时返回 false）
+     */
+    bool tryPush(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            
+            if (diff == 0) {
+                // 槽位空闲，领取该位置；失败时 pos 被更新为最新值后重试
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // 消费者尚未读走上一轮的数据，队列已满
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    /**
+     * @brief 尝试读出一个元素（只能由一个消费者线程调用）
+     * @param value 输出元素
+     * @return 是否读到元素
+     */
+    bool tryPop(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        
+        // 序号为 pos + 1 表示生产者已发布数据；生产者领取后尚未发布时也视为空
+        if (sequence != pos + 1) {
+            return false;
+        }
+        
+        value = std::move(cell.value);
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief 获取容量
+     * @return 槽位数
+     */
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    
+    static const size_t kCacheLineSize = 64;
+    
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    
+    // 生产者与消费者的位置放在不同缓存行，避免伪共享
+    char pad0_[kCacheLineSize];
+    std::atomic<size_t> enqueue_pos_;
+    char pad1_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeue_pos_;
+    char pad2_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 单线程 FIFO 环形缓冲区
+ * 
+ * 容量始终为 2 的幂，通过掩码定位槽位；元素以移动方式存取，
+ * 入队、出队均为 O(1)。缓冲区满时按倍数扩容（保持 FIFO 顺序）。
+ * head/tail 为单调递增的绝对位置，可用于在外部索引中引用元素。
+ * 
+ * 本类不做同步，由调用方加锁。
+ */
+template <typename T>
+class RingBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 初始容量（向上取整为 2 的幂）
+     */
+    explicit RingBuffer(size_t capacity = 0)
+        : mask_(0)
+        , head_(0)
+        , tail_(0) {
+        reserve(capacity);
+    }
+    
+    /**
+     * @brief 预分配容量，已有元素保持原有顺序
+     * @param capacity 期望容量
+     */
+    void reserve(size_t capacity) {
+        if (capacity <= slots_.size()) {
+            return;
+        }
+        
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        
+        // 按绝对位置重新放置，保证扩容前后位置编号不变
+        std::vector<T> slots(rounded);
+        for (uint64_t pos = head_; pos != tail_; ++pos) {
+            slots[pos & (rounded - 1)] = std::move(slots_[pos & mask_]);
+        }
+        
+        slots_.swap(slots);
+        mask_ = rounded - 1;
+    }
+    
+    /**
+     * @brief 移入一个元素到队尾，必要时扩容
+     * @param item 元素
+     */
+    void push(T&& item) {
+        if (size() == slots_.size()) {
+            reserve(slots_.empty() ? 16 : slots_.size() * 2);
+        }
+        slots_[tail_ & mask_] = std::move(item);
+        ++tail_;
+    }
+    
+    /**
+     * @brief 移入一个元素到队首（放回刚取出的元素），必要时扩容
+     * @param item 元素
+     */
+    void pushFront(T&& item) {
+        if (size() == slots_.size()) {
+            reserve(slots_.empty() ? 16 : slots_.size() * 2);
+        }
+        --head_;
+        slots_[head_ & mask_] = std::move(item);
+    }
+    
+    /**
+     * @brief 获取队首元素（调用前需保证非空）
+     * @return 队首元素引用
+     */
+    T& front() {
+        return slots_[head_ & mask_];
+    }
+    
+    const T& front() const {
+        return slots_[head_ & mask_];
+    }
+    
+    /**
+     * @brief 弹出队首元素并移出到 out
+     * @param out 输出元素
+     * @return 队列为空时返回 false
+     */
+    bool pop(T& out) {
+        if (empty()) {
+            return false;
+        }
+        out = std::move(slots_[head_ & mask_]);
+        slots_[head_ & mask_] = T();
+        ++head_;
+        return true;
+    }
+    
+    /**
+     * @brief 丢弃队首元素
+     */
+    void pop() {
+        if (!empty()) {
+            slots_[head_ & mask_] = T();
+            ++head_;
+        }
+    }
+    
+    /**
+     * @brief 清空所有元素（保留已分配容量）
+     */
+    void clear() {
+        while (!empty()) {
+            pop();
+        }
+    }
+    
+    /**
+     * @brief 按绝对位置访问元素（调用前需保证 head() <= position < tail()）
+     * @param position 绝对位置
+     * @return 元素引用
+     */
+    T& at(uint64_t position) {
+        return slots_[position & mask_];
+    }
+    
+    /**
+     * @brief 队首元素的绝对位置
+     */
+    uint64_t head() const { return head_; }
+    
+    /**
+     * @brief 下一个入队元素的绝对位置
+     */
+    uint64_t tail() const { return tail_; }
+    
+    size_t size() const { return static_cast<size_t>(tail_ - head_); }
+    bool empty() const { return head_ == tail_; }
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_;
+    uint64_t head_;
+    uint64_t tail_;
+};
+
+} // namespace cross_platform_websocket
@@ -1,6 +1,7 @@
 #include "datalink.h"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 
 namespace cross_platform_websocket {
 
@@ -13,11 +14,11 @@ DataLink::DataLink(std::shared_ptr<PlatformInterface> platform,
     , max_reconnect_attempts_(5)
     , reconnect_interval_ms_(1000)
     , current_reconnect_attempts_(0)
-    , messages_sent_(0)
-    , messages_received_(0)
-    , bytes_sent_(0)
-    , bytes_received_(0)
     , connection_start_time_(0)
+    , connect_attempt_latency_(LatencyHistogram::kShortValueBits)
+    , ping_rtt_(LatencyHistogram::kShortValueBits)
+    , connect_requested_ns_(0)
+    , ping_sent_ns_(0)
     , reconnect_thread_(nullptr)
     , reconnect_thread_running_(false) {
     
@@ -30,24 +31,26 @@ DataLink::~DataLink() {
 }
 
 bool DataLink::connect(const std::string& url) {
-    if (connection_state_ == ConnectionState::CONNECTED) {
+    if (connection_state_.load(std::memory_order_acquire) == ConnectionState::CONNECTED) {
         LOG_WARNING("WebSocket 已经连接");
         return true;
     }
     
-    if (connection_state_ == ConnectionState::CONNECTING) {
+    if (connection_state_.load(std::memory_order_acquire) == ConnectionState::CONNECTING) {
         LOG_WARNING("WebSocket 正在连接中");
         return false;
     }
     
     server_url_ = url;
+    connect_requested_ns_ = LatencyHistogram::nowNanos();
     updateConnectionState(ConnectionState::CONNECTING);
     
     LOG_INFO("正在连接到: " + url);
     
     // 使用平台接口建立连接
+    uint64_t attempt_start = LatencyHistogram::nowNanos();
     if (platform_->websocketConnect(url)) {
-        handleConnectionSuccess();
+        handleConnectionSuccess(attempt_start);
         return true;
     } else {
         handleConnectionError("连接失败");
@@ -56,7 +59,7 @@ bool DataLink::connect(const std::string& url) {
 }
 
 void DataLink::disconnect() {
-    if (connection_state_ == ConnectionState::DISCONNECTED) {
+    if (connection_state_.load(std::memory_order_acquire) == ConnectionState::DISCONNECTED) {
         return;
     }
     
@@ -77,10 +80,16 @@ bool DataLink::sendText(const std::string& message) {
         return false;
     }
     
-    if (platform_->websocketSend(message)) {
-        messages_sent_++;
-        bytes_sent_ += message.length();
-        LOG_DEBUG("发送文本消息: " + message);
+    bool sent;
+    {
+        std::lock_guard<std::mutex> message_lock(message_mutex_);
+        std::lock_guard<std::mutex> frame_lock(frame_mutex_);
+        sent = platform_->websocketSend(message);
+    }
+    if (sent) {
+        stats_.add(STAT_MESSAGES_SENT);
+        stats_.add(STAT_BYTES_SENT, message.length());
+        LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "发送文本消息: " + message);
         return true;
     } else {
         LOG_ERROR("发送文本消息失败");
@@ -89,18 +98,26 @@ bool DataLink::sendText(const std::string& message) {
 }
 
 bool DataLink::sendBinary(const std::vector<uint8_t>& data) {
+    return sendBinary(data.data(), data.size());
+}
+
+bool DataLink::sendBinary(const uint8_t* data, size_t length) {
     if (!isConnected()) {
         LOG_ERROR("WebSocket 未连接，无法发送二进制消息");
         return false;
     }
     
-    // 将二进制数据转换为字符串（这里简化处理）
-    std::string binary_str(data.begin(), data.end());
-    
-    if (platform_->websocketSend(binary_str)) {
-        messages_sent_++;
-        bytes_sent_ += data.size();
-        LOG_DEBUG("发送二进制消息，大小: " + std::to_string(data.size()) + " 字节");
+    // 直接传递连续内存，不再复制为字符串
+    bool sent;
+    {
+        std::lock_guard<std::mutex> message_lock(message_mutex_);
+        std::lock_guard<std::mutex> frame_lock(frame_mutex_);
+        sent = platform_->websocketSendBinary(data, length);
+    }
+    if (sent) {
+        stats_.add(STAT_MESSAGES_SENT);
+        stats_.add(STAT_BYTES_SENT, length);
+        LOG_DEBUGF("发送二进制消息，大小: {} 字节", length);
         return true;
     } else {
         LOG_ERROR("发送二进制消息失败");
@@ -108,14 +125,66 @@ bool DataLink::sendBinary(const std::vector<uint8_t>& data) {
     }
 }
 
+bool DataLink::sendData(const char* data, size_t length, bool is_binary) {
+    return sendFragmented(data, length, is_binary, 0);
+}
+
+bool DataLink::sendFragmented(const char* data, size_t length, bool is_binary, size_t fragment_size) {
+    if (!isConnected()) {
+        LOG_ERROR("WebSocket 未连接，无法发送消息");
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> message_lock(message_mutex_);
+    if (fragment_size == 0 || length <= fragment_size || !platform_->websocketSupportsFragments()) {
+        bool sent;
+        {
+            std::lock_guard<std::mutex> frame_lock(frame_mutex_);
+            sent = platform_->websocketSendData(data, length, is_binary);
+        }
+        if (!sent) {
+            LOG_ERROR("发送消息失败");
+            return false;
+        }
+    } else {
+        for (size_t offset = 0; offset < length; offset += fragment_size) {
+            size_t fragment_length = std::min(fragment_size, length - offset);
+            bool is_final = offset + fragment_length == length;
+            bool sent;
+            {
+                // 每帧单独取帧锁，分片之间 Ping 可以插入
+                std::lock_guard<std::mutex> frame_lock(frame_mutex_);
+                sent = platform_->websocketSendFragment(data + offset, fragment_length, is_binary,
+                                                        offset == 0, is_final);
+            }
+            if (!sent) {
+                LOG_ERROR("发送消息分片失败，偏移: " + std::to_string(offset));
+                return false;
+            }
+        }
+    }
+    
+    stats_.add(STAT_MESSAGES_SENT);
+    stats_.add(STAT_BYTES_SENT, length);
+    LOG_DEBUGF("发送消息，大小: {} 字节", length);
+    return true;
+}
+
 bool DataLink::sendPing() {
     if (!isConnected()) {
         LOG_ERROR("WebSocket 未连接，无法发送 Ping");
         return false;
     }
     
-    // 发送 Ping 消息（这里简化处理）
-    if (platform_->websocketSend("PING")) {
+    // 发送 Ping 消息（这里简化处理），收到 Pong 时按最近一次 Ping 计算往返时间
+    bool sent;
+    {
+        // 只取帧锁，不等待正在分片发送的数据消息
+        std::lock_guard<std::mutex> frame_lock(frame_mutex_);
+        ping_sent_ns_.store(LatencyHistogram::nowNanos(), std::memory_order_relaxed);
+        sent = platform_->websocketSend("PING");
+    }
+    if (sent) {
         LOG_DEBUG("发送 Ping 消息");
         return true;
     } else {
@@ -125,11 +194,11 @@ bool DataLink::sendPing() {
 }
 
 ConnectionState DataLink::getConnectionState() const {
-    return connection_state_;
+    return connection_state_.load(std::memory_order_acquire);
 }
 
 bool DataLink::isConnected() const {
-    return connection_state_ == ConnectionState::CONNECTED;
+    return connection_state_.load(std::memory_order_acquire) == ConnectionState::CONNECTED;
 }
 
 void DataLink::setConnectionCallback(ConnectionCallback callback) {
@@ -163,7 +232,7 @@ std::string DataLink::getStatistics() const {
     oss << "连接统计信息:\n";
     oss << "  连接状态: ";
     
-    switch (connection_state_) {
+    switch (connection_state_.load(std::memory_order_acquire)) {
         case ConnectionState::DISCONNECTED: oss << "已断开"; break;
         case ConnectionState::CONNECTING: oss << "连接中"; break;
         case ConnectionState::CONNECTED: oss << "已连接"; break;
@@ -172,23 +241,59 @@ std::string DataLink::getStatistics() const {
     }
     
     oss << "\n";
-    oss << "  发送消息数: " << messages_sent_ << "\n";
-    oss << "  接收消息数: " << messages_received_ << "\n";
-    oss << "  发送字节数: " << bytes_sent_ << "\n";
-    oss << "  接收字节数: " << bytes_received_ << "\n";
+    DataLinkStats stats = getStats();
+    oss << "  发送消息数: " << stats.messages_sent << "\n";
+    oss << "  接收消息数: " << stats.messages_received << "\n";
+    oss << "  发送字节数: " << stats.bytes_sent << "\n";
+    oss << "  接收字节数: " << stats.bytes_received << "\n";
     
-    if (connection_start_time_ > 0) {
+    uint64_t start_time = connection_start_time_.load(std::memory_order_relaxed);
+    if (start_time > 0) {
         uint64_t current_time = platform_->getCurrentTimestamp();
-        uint64_t duration = current_time - connection_start_time_;
+        uint64_t duration = current_time - start_time;
         oss << "  连接时长: " << duration << "ms\n";
     }
     
     return oss.str();
 }
 
+DataLinkStats DataLink::getStats() const {
+    DataLinkStats stats;
+    stats.messages_sent = stats_.get(STAT_MESSAGES_SENT);
+    stats.messages_received = stats_.get(STAT_MESSAGES_RECEIVED);
+    stats.bytes_sent = stats_.get(STAT_BYTES_SENT);
+    stats.bytes_received = stats_.get(STAT_BYTES_RECEIVED);
+    
+    uint64_t start_time = connection_start_time_.load(std::memory_order_relaxed);
+    uint64_t now = isConnected() && start_time > 0 ? platform_->getCurrentTimestamp() : 0;
+    stats.connected_ms = now > start_time ? now - start_time : 0;
+    return stats;
+}
+
+LatencySnapshot DataLink::getLatencySnapshot(LatencyMetric metric) const {
+    switch (metric) {
+        case LatencyMetric::CONNECT_ATTEMPT: return connect_attempt_latency_.snapshot();
+        case LatencyMetric::CONNECT_TOTAL: return connect_total_latency_.snapshot();
+        case LatencyMetric::PING_RTT: return ping_rtt_.snapshot();
+        default: return LatencySnapshot();
+    }
+}
+
+void DataLink::resetLatencyHistograms() {
+    connect_attempt_latency_.reset();
+    connect_total_latency_.reset();
+    ping_rtt_.reset();
+}
+
+void DataLink::enableLatencyTracking(bool enabled) {
+    connect_attempt_latency_.setEnabled(enabled);
+    connect_total_latency_.setEnabled(enabled);
+    ping_rtt_.setEnabled(enabled);
+}
+
 void DataLink::updateConnectionState(ConnectionState new_state) {
-    if (connection_state_ != new_state) {
-        connection_state_ = new_state;
+    // 交换后比较，多个线程同时切换到同一状态时只回调一次
+    if (connection_state_.exchange(new_state, std::memory_order_acq_rel) != new_state) {
         LOG_INFO("连接状态更新: " + std::to_string(static_cast<int>(new_state)));
         
         if (connection_callback_) {
@@ -197,14 +302,23 @@ void DataLink::updateConnectionState(ConnectionState new_state) {
     }
 }
 
-void DataLink::handleConnectionSuccess() {
-    connection_start_time_ = platform_->getCurrentTimestamp();
+void DataLink::handleConnectionSuccess(uint64_t attempt_start_ns) {
+    connect_attempt_latency_.recordSince(attempt_start_ns);
+    connect_total_latency_.recordSince(connect_requested_ns_);
+    connect_requested_ns_ = 0;
+    ping_sent_ns_.store(0, std::memory_order_relaxed);
+    
+    connection_start_time_.store(platform_->getCurrentTimestamp(), std::memory_order_relaxed);
     current_reconnect_attempts_ = 0;
     updateConnectionState(ConnectionState::CONNECTED);
     LOG_INFO("WebSocket 连接成功");
 }
 
 void DataLink::handleConnectionError(const std::string& error) {
+    // 连接中断后的重连耗时从中断时刻算起
+    if (connect_requested_ns_ == 0) {
+        connect_requested_ns_ = LatencyHistogram::nowNanos();
+    }
     updateConnectionState(ConnectionState::ERROR);
     LOG_ERROR("WebSocket 连接错误: " + error);
     
@@ -219,10 +333,16 @@ void DataLink::handleConnectionError(const std::string& error) {
 }
 
 void DataLink::handleMessageReceived(const WebSocketMessage& message) {
-    messages_received_++;
-    bytes_received_ += message.data.length();
+    stats_.add(STAT_MESSAGES_RECEIVED);
+    stats_.add(STAT_BYTES_RECEIVED, message.data.size());
+    
+    if (message.type == MessageType::PONG ||
+        (message.type == MessageType::TEXT && message.data.size() == 4 &&
+         std::memcmp(message.data.data(), "PONG", 4) == 0)) {
+        ping_rtt_.recordSince(ping_sent_ns_.exchange(0, std::memory_order_relaxed));
+    }
     
-    LOG_DEBUG("接收消息: " + message.data);
+    LOG_DEBUG_RATE(WS_LOG_HOT_PATH_RATE, "接收消息: " + message.data.str());
     
     if (message_callback_) {
         message_callback_(message);
@@ -266,8 +386,9 @@ void DataLink::attemptReconnect() {
     
     LOG_INFO("尝试重连到: " + server_url_);
     
+    uint64_t attempt_start = LatencyHistogram::nowNanos();
     if (platform_->websocketConnect(server_url_)) {
-        handleConnectionSuccess();
+        handleConnectionSuccess(attempt_start);
         reconnect_thread_running_ = false;
     } else {
         if (current_reconnect_attempts_ >= max_reconnect_attempts_) {
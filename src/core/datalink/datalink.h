@@ -2,9 +2,14 @@
 
 #include "../../platform/platform_interface.h"
 #include "../logger/logger.h"
+#include "../memory/payload.h"
+#include "../metrics/latency_histogram.h"
+#include "../metrics/sharded_counter.h"
+#include <atomic>
 #include <string>
 #include <memory>
 #include <functional>
+#include <mutex>
 #include <vector>
 
 namespace cross_platform_websocket {
@@ -36,11 +41,25 @@ enum class MessageType {
  */
 struct WebSocketMessage {
     MessageType type;
-    std::string data;
+    Payload data;           // 小消息内联存放，不分配内存
     uint64_t timestamp;
     
     WebSocketMessage(MessageType t, const std::string& d)
         : type(t), data(d), timestamp(0) {}
+    
+    WebSocketMessage(MessageType t, const char* d, size_t size)
+        : type(t), data(d, size), timestamp(0) {}
+};
+
+/**
+ * @brief 数据链路层统计信息
+ */
+struct DataLinkStats {
+    uint64_t messages_sent;       // 写入传输层的消息数
+    uint64_t messages_received;   // 接收消息数
+    uint64_t bytes_sent;          // 发送字节数
+    uint64_t bytes_received;      // 接收字节数
+    uint64_t connected_ms;        // 当前连接已持续的时间（毫秒），未连接时为 0
 };
 
 /**
@@ -104,6 +123,38 @@ public:
      */
     bool sendBinary(const std::vector<uint8_t>& data);
     
+    /**
+     * @brief 发送二进制消息（不复制）
+     * @param data 二进制数据指针
+     * @param length 字节数
+     * @return 是否发送成功
+     */
+    bool sendBinary(const uint8_t* data, size_t length);
+    
+    /**
+     * @brief 发送一段连续内存中的消息（不复制）
+     * @param data 数据指针
+     * @param length 字节数
+     * @param is_binary 是否为二进制消息
+     * @return 是否发送成功
+     */
+    bool sendData(const char* data, size_t length, bool is_binary);
+    
+    /**
+     * @brief 按分片大小发送一条消息
+     * 
+     * 消息超过分片大小且平台支持分片时，拆成连续的 continuation 帧逐片写入，否则整条发送。
+     * 整个分片循环持有消息锁，其他消息的数据帧不会插入到分片之间；每帧写入只短暂持有帧锁，
+     * Ping 等控制帧可以插入到分片之间（RFC 6455 §5.4 允许）。
+     * 
+     * @param data 数据指针
+     * @param length 字节数
+     * @param is_binary 是否为二进制消息
+     * @param fragment_size 分片大小（字节），0 表示不分片
+     * @return 是否发送成功
+     */
+    bool sendFragmented(const char* data, size_t length, bool is_binary, size_t fragment_size);
+    
     /**
      * @brief 发送 Ping 消息
      * @return 是否发送成功
@@ -153,14 +204,45 @@ public:
      * @return 统计信息字符串
      */
     std::string getStatistics() const;
+    
+    /**
+     * @brief 获取统计计数（不加锁、不分配内存）
+     * @return 统计信息
+     */
+    DataLinkStats getStats() const;
+    
+    /**
+     * @brief 获取本链路记录的延迟指标副本
+     * @param metric CONNECT_ATTEMPT、CONNECT_TOTAL 或 PING_RTT（其他指标返回空副本）
+     * @return 副本
+     */
+    LatencySnapshot getLatencySnapshot(LatencyMetric metric) const;
+    
+    /**
+     * @brief 清空本链路的延迟直方图
+     */
+    void resetLatencyHistograms();
+    
+    /**
+     * @brief 启用或禁用本链路的延迟记录（默认启用）
+     * @param enabled 是否启用
+     */
+    void enableLatencyTracking(bool enabled);
 
 private:
+    /**
+     * @brief 日志宏使用的上下文：写入本实例的日志器，按 DATALINK 模块的级别过滤
+     */
+    LogContext wsLogContext(LogContextTag) const {
+        return LogContext(logger_.get(), LogModule::DATALINK);
+    }
+    
     std::shared_ptr<PlatformInterface> platform_;
     std::shared_ptr<Logger> logger_;
     
     // 连接相关
     std::string server_url_;
-    ConnectionState connection_state_;
+    std::atomic<ConnectionState> connection_state_;  // 重连、心跳线程写入，发送线程和监控线程读取
     bool auto_reconnect_enabled_;
     int max_reconnect_attempts_;
     int reconnect_interval_ms_;
@@ -171,16 +253,37 @@ private:
     MessageCallback message_callback_;
     ErrorCallback error_callback_;
     
-    // 统计信息
-    uint64_t messages_sent_;
-    uint64_t messages_received_;
-    uint64_t bytes_sent_;
-    uint64_t bytes_received_;
-    uint64_t connection_start_time_;
+    // 消息锁：数据消息发送期间持有，保证一条分片消息的各帧连续写出，不与其他数据消息交错
+    std::mutex message_mutex_;
+    // 帧锁：每次调用传输层写入时持有，Ping 只取帧锁，可在分片之间发出
+    std::mutex frame_mutex_;
+    
+    // 统计信息（发送线程、重连线程和调用方线程都会更新，按线程分片计数）
+    enum StatCounter {
+        STAT_MESSAGES_SENT,
+        STAT_MESSAGES_RECEIVED,
+        STAT_BYTES_SENT,
+        STAT_BYTES_RECEIVED,
+        STAT_COUNT
+    };
+    ShardedCounters<STAT_COUNT> stats_;
+    std::atomic<uint64_t> connection_start_time_;
+    
+    // 延迟统计（桶数组在第一次记录时分配：握手和 Ping 往返各约 7.5KB，总连接耗时约 9KB）
+    LatencyHistogram connect_attempt_latency_;
+    LatencyHistogram connect_total_latency_;
+    LatencyHistogram ping_rtt_;
+    uint64_t connect_requested_ns_;          // 发起连接的时刻，连接建立后清零
+    std::atomic<uint64_t> ping_sent_ns_;     // 最近一次未收到响应的 Ping 的发送时刻
     
     // 内部方法
     void updateConnectionState(ConnectionState new_state);
-    void handleConnectionSuccess();
+    
+    /**
+     * @brief 处理连接成功
+     * @param attempt_start_ns 本次握手开始的时刻
+     */
+    void handleConnectionSuccess(uint64_t attempt_start_ns);
     void handleConnectionError(const std::string& error);
     void handleMessageReceived(const WebSocketMessage& message);
     void startReconnectTimer();
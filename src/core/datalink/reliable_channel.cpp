@@ -0,0 +1,181 @@
+#include "reliable_channel.h"
+#include <cstring>
+
+namespace cross_platform_websocket {
+
+const char* const ReliableChannel::kDataPrefix = "@rd:";
+const char* const ReliableChannel::kAckPrefix = "@ra:";
+
+ReliableChannel::ReliableChannel(DataLink& datalink, std::shared_ptr<Logger> logger,
+                                 const ReliableChannelOptions& options)
+    : datalink_(datalink)
+    , logger_(logger)
+    , options_(options)
+    , next_sequence_(1)
+    , retransmits_(0) {
+    
+    if (options_.window_size == 0) {
+        options_.window_size = 1;
+    }
+    in_flight_.reserve(options_.window_size);
+}
+
+ReliableChannel::~ReliableChannel() {
+    failAll("可靠通道已关闭");
+}
+
+bool ReliableChannel::send(const char* data, size_t size, MessageType type,
+                           DeliveryCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // 只有需要在窗口外等待的消息才受待发送上限约束，max_pending 为 0 时窗口有空位仍可发送
+    bool window_open = pending_.empty() && in_flight_.size() < options_.window_size &&
+                       datalink_.isConnected();
+    if (!window_open && pending_.size() >= options_.max_pending) {
+        LOG_WARNING("可靠通道待发送队列已满");
+        return false;
+    }
+    
+    Entry entry;
+    entry.sequence = next_sequence_++;
+    entry.type = type;
+    entry.callback = std::move(callback);
+    
+    std::string sequence = std::to_string(entry.sequence);
+    size_t prefix_length = std::strlen(kDataPrefix);
+    entry.frame.reserve(prefix_length + sequence.size() + 1 + size);
+    entry.frame.append(kDataPrefix, prefix_length);
+    entry.frame.append(sequence);
+    entry.frame.push_back(':');
+    entry.frame.append(data, size);
+    
+    pending_.push(std::move(entry));
+    fillWindow();
+    return true;
+}
+
+bool ReliableChannel::handleIncoming(const char* data, size_t size) {
+    size_t prefix_length = std::strlen(kAckPrefix);
+    if (size < prefix_length || std::memcmp(data, kAckPrefix, prefix_length) != 0) {
+        return false;
+    }
+    
+    // 负载不保证以 '\0' 结尾，逐位解析序号
+    uint64_t acked = 0;
+    size_t position = prefix_length;
+    while (position < size && data[position] >= '0' && data[position] <= '9') {
+        acked = acked * 10 + static_cast<uint64_t>(data[position] - '0');
+        position++;
+    }
+    if (position == prefix_length) {
+        LOG_WARNING("无效的确认帧: " + std::string(data, size));
+        return true;
+    }
+    
+    std::vector<DeliveryCallback> delivered;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        // 累积确认：序号不超过 acked 的消息全部完成
+        Entry entry;
+        while (!in_flight_.empty() && in_flight_.front().sequence <= acked) {
+            in_flight_.pop(entry);
+            if (entry.callback) {
+                delivered.push_back(std::move(entry.callback));
+            }
+            entry.frame.release();
+        }
+        
+        fillWindow();
+    }
+    
+    for (const auto& callback : delivered) {
+        callback(true, "");
+    }
+    return true;
+}
+
+void ReliableChannel::onConnected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // 按序重放断线前未确认的消息
+    for (uint64_t pos = in_flight_.head(); pos != in_flight_.tail(); ++pos) {
+        if (!write(in_flight_.at(pos))) {
+            return;
+        }
+        retransmits_++;
+    }
+    
+    if (in_flight_.size() > 0) {
+        LOG_INFO("重放未确认消息: " + std::to_string(in_flight_.size()) + " 条");
+    }
+    
+    fillWindow();
+}
+
+void ReliableChannel::failAll(const std::string& reason) {
+    std::vector<DeliveryCallback> failed;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry entry;
+        while (in_flight_.pop(entry) || pending_.pop(entry)) {
+            if (entry.callback) {
+                failed.push_back(std::move(entry.callback));
+            }
+            entry.frame.release();
+        }
+    }
+    
+    for (const auto& callback : failed) {
+        callback(false, reason);
+    }
+}
+
+size_t ReliableChannel::inFlightCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_.size();
+}
+
+size_t ReliableChannel::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+uint64_t ReliableChannel::retransmitCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return retransmits_;
+}
+
+ReliableChannelStats ReliableChannel::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReliableChannelStats stats;
+    stats.in_flight = in_flight_.size();
+    stats.pending = pending_.size();
+    stats.retransmits = retransmits_;
+    return stats;
+}
+
+void ReliableChannel::fillWindow() {
+    if (!datalink_.isConnected()) {
+        return;
+    }
+    
+    while (!pending_.empty() && in_flight_.size() < options_.window_size) {
+        // 写入失败（如连接刚断开）也移入窗口，重连后随未确认消息一起重放
+        bool written = write(pending_.front());
+        Entry entry;
+        pending_.pop(entry);
+        in_flight_.push(std::move(entry));
+        if (!written) {
+            break;
+        }
+    }
+}
+
+bool ReliableChannel::write(const Entry& entry) {
+    return datalink_.sendData(entry.frame.data(), entry.frame.size(), entry.type == MessageType::BINARY);
+}
+
+} // namespace cross_platform_websocket
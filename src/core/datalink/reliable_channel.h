@@ -0,0 +1,176 @@
+#pragma once
+
+#include "datalink.h"
+#include "../container/ring_buffer.h"
+#include "../memory/payload.h"
+#include "../logger/logger.h"
+#include <string>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 投递结果回调函数类型（收到确认时 success 为 true）
+ */
+using DeliveryCallback = std::function<void(bool success, const std::string& reason)>;
+
+/**
+ * @brief 可靠投递配置
+ */
+struct ReliableChannelOptions {
+    size_t window_size;   // 已发送未确认的最大消息数
+    size_t max_pending;   // 等待进入窗口（含离线期间）的最大消息数，0 表示不缓冲（窗口满或离线时拒绝）
+    
+    ReliableChannelOptions()
+        : window_size(256)
+        , max_pending(4096) {}
+};
+
+/**
+ * @brief 可靠通道统计信息
+ */
+struct ReliableChannelStats {
+    uint64_t in_flight;     // 已发送未确认的消息数
+    uint64_t pending;       // 等待进入窗口的消息数
+    uint64_t retransmits;   // 重传次数
+};
+
+/**
+ * @brief 建立在 DataLink 之上的至少一次投递通道
+ * 
+ * 每条出站消息分配递增序号并封装为 "@rd:<序号>:<负载>"，服务器以
+ * "@ra:<序号>" 累积确认已收到的最大连续序号。已发送未确认的消息保留在
+ * 重传缓冲区中，窗口满时新消息在待发送队列中等待；重连后先按序重放未确认
+ * 的消息，再继续发送待发送队列。服务器需按序号去重。
+ * 
+ * 重传帧存放在 BufferPool 分配的 Payload 中，确认后归还内存池复用。
+ */
+class ReliableChannel {
+public:
+    /**
+     * @brief 数据帧前缀
+     */
+    static const char* const kDataPrefix;
+    
+    /**
+     * @brief 确认帧前缀
+     */
+    static const char* const kAckPrefix;
+    
+    /**
+     * @brief 构造函数
+     * @param datalink 数据链路层（生命周期需长于本通道）
+     * @param logger 日志器指针
+     * @param options 窗口配置
+     */
+    ReliableChannel(DataLink& datalink, std::shared_ptr<Logger> logger,
+                    const ReliableChannelOptions& options = ReliableChannelOptions());
+    
+    /**
+     * @brief 析构函数（未确认和待发送消息以失败结果完成）
+     */
+    ~ReliableChannel();
+    
+    /**
+     * @brief 发送消息
+     * @param data 消息负载
+     * @param size 负载字节数
+     * @param type 消息类型（TEXT 或 BINARY）
+     * @param callback 投递结果回调（收到确认或最终失败时调用）
+     * @return 是否被接受（待发送队列已满时返回 false，且不调用回调）
+     */
+    bool send(const char* data, size_t size, MessageType type, DeliveryCallback callback);
+    
+    /**
+     * @brief 处理入站消息中的确认帧
+     * @param data 入站消息数据
+     * @param size 入站消息字节数
+     * @return 是否为确认帧（确认帧不应再交给上层）
+     */
+    bool handleIncoming(const char* data, size_t size);
+    
+    /**
+     * @brief 连接建立后重放未确认的消息并继续发送
+     */
+    void onConnected();
+    
+    /**
+     * @brief 以失败结果完成所有未确认和待发送的消息
+     * @param reason 失败原因
+     */
+    void failAll(const std::string& reason);
+    
+    /**
+     * @brief 获取已发送未确认的消息数
+     * @return 消息数
+     */
+    size_t inFlightCount() const;
+    
+    /**
+     * @brief 获取等待进入窗口的消息数
+     * @return 消息数
+     */
+    size_t pendingCount() const;
+    
+    /**
+     * @brief 获取重传次数
+     * @return 重传次数
+     */
+    uint64_t retransmitCount() const;
+    
+    /**
+     * @brief 一次加锁取得所有统计信息
+     * @return 统计信息
+     */
+    ReliableChannelStats getStats() const;
+
+private:
+    /**
+     * @brief 日志宏使用的上下文：写入本实例的日志器，按 DATALINK 模块的级别过滤
+     */
+    LogContext wsLogContext(LogContextTag) const {
+        return LogContext(logger_.get(), LogModule::DATALINK);
+    }
+    
+    ReliableChannel(const ReliableChannel&) = delete;
+    ReliableChannel& operator=(const ReliableChannel&) = delete;
+    
+    /**
+     * @brief 通道中的一条消息
+     */
+    struct Entry {
+        uint64_t sequence;
+        Payload frame;        // 已封装的帧
+        MessageType type;
+        DeliveryCallback callback;
+        
+        Entry() : sequence(0), type(MessageType::TEXT) {}
+    };
+    
+    DataLink& datalink_;
+    std::shared_ptr<Logger> logger_;
+    ReliableChannelOptions options_;
+    
+    mutable std::mutex mutex_;
+    RingBuffer<Entry> in_flight_;   // 已发送未确认，序号连续递增
+    RingBuffer<Entry> pending_;     // 等待进入窗口
+    uint64_t next_sequence_;
+    uint64_t retransmits_;
+    
+    /**
+     * @brief 在窗口允许时发送待发送队列中的消息（调用时需持有 mutex_）
+     */
+    void fillWindow();
+    
+    /**
+     * @brief 写入一帧（调用时需持有 mutex_）
+     * @param entry 消息
+     * @return 是否写入成功
+     */
+    bool write(const Entry& entry);
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,205 @@
+#include "binary_log.h"
+#include <utility>
+
+namespace cross_platform_websocket {
+
+// 输出实例编号（线程缓冲区按编号查找，编号不复用）
+static std::atomic<uint64_t> g_next_sink_id(1);
+
+// ==================== LogFormatRegistry ====================
+
+LogFormatRegistry& LogFormatRegistry::instance() {
+    // 故意不析构：静态对象析构之后仍可能有线程写日志
+    static LogFormatRegistry* registry = new LogFormatRegistry();
+    return *registry;
+}
+
+uint32_t LogFormatRegistry::add(uint8_t level, const char* format, const char* file, int line) {
+    Entry entry;
+    entry.level = level;
+    entry.line = line;
+    entry.file = file ? file : "";
+    entry.format = format ? format : "";
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(std::move(entry));
+    return static_cast<uint32_t>(entries_.size() - 1);
+}
+
+size_t LogFormatRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+bool LogFormatRegistry::get(uint32_t id, Entry& entry) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= entries_.size()) {
+        return false;
+    }
+    entry = entries_[id];
+    return true;
+}
+
+// ==================== BinaryLogSink ====================
+
+BinaryLogSink::BinaryLogSink(size_t buffer_size)
+    : sink_id_(g_next_sink_id++)
+    , buffer_size_(buffer_size)
+    , open_(false)
+    , records_dropped_(0)
+    , file_(nullptr)
+    , definitions_written_(0)
+    , next_thread_index_(0) {
+}
+
+BinaryLogSink::~BinaryLogSink() {
+    close();
+}
+
+bool BinaryLogSink::open(const std::string& path) {
+    close();
+    
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    
+    std::fwrite(binary_log::kMagic, 1, sizeof(binary_log::kMagic), file_);
+    std::fwrite(&binary_log::kVersion, sizeof(binary_log::kVersion), 1, file_);
+    
+    // 每个文件独立可解码，格式定义需要重新写出
+    definitions_written_ = 0;
+    open_ = true;
+    return true;
+}
+
+void BinaryLogSink::close() {
+    if (open_.exchange(false)) {
+        flush();
+        
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        if (file_) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+    
+    // 未打开时也可能有线程登记过缓冲区，析构前同样需要释放
+    retireBuffers();
+}
+
+void BinaryLogSink::retireBuffers() {
+    std::vector<std::shared_ptr<ThreadBuffer>> retired;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        retired.swap(buffers_);
+    }
+    
+    for (auto& buffer : retired) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->data.reset();
+        buffer->used = 0;
+        buffer->retired.store(true, std::memory_order_release);
+    }
+}
+
+BinaryLogSink::ThreadBuffer* BinaryLogSink::threadBuffer() {
+    // 一个线程通常只写一个输出，线性查找即可；顺带清除已关闭输出的登记项
+    static thread_local std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> buffers;
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        if (it->second->retired.load(std::memory_order_acquire)) {
+            it = buffers.erase(it);
+        } else if (it->first == sink_id_) {
+            return it->second.get();
+        } else {
+            ++it;
+        }
+    }
+    
+    std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+    buffer->data = std::unique_ptr<char[]>(new char[buffer_size_]);
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffer->thread_index = next_thread_index_++;
+        buffers_.push_back(buffer);
+    }
+    buffers.push_back(std::make_pair(sink_id_, buffer));
+    return buffer.get();
+}
+
+void BinaryLogSink::commit(ThreadBuffer& buffer) {
+    if (buffer.used == 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    if (file_) {
+        writeDefinitions();
+        std::fwrite(buffer.data.get(), 1, buffer.used, file_);
+    }
+    buffer.used = 0;
+}
+
+void BinaryLogSink::writeDefinitions() {
+    LogFormatRegistry& registry = LogFormatRegistry::instance();
+    size_t count = registry.size();
+    
+    LogFormatRegistry::Entry entry;
+    for (; definitions_written_ < count; ++definitions_written_) {
+        if (!registry.get(static_cast<uint32_t>(definitions_written_), entry)) {
+            break;
+        }
+        
+        uint32_t id = static_cast<uint32_t>(definitions_written_);
+        uint32_t line = static_cast<uint32_t>(entry.line);
+        uint16_t file_length = static_cast<uint16_t>(entry.file.size() > 0xFFFF ? 0xFFFF : entry.file.size());
+        uint32_t format_length = static_cast<uint32_t>(entry.format.size());
+        
+        std::fputc(binary_log::kRecordDefinition, file_);
+        std::fwrite(&id, sizeof(id), 1, file_);
+        std::fwrite(&entry.level, sizeof(entry.level), 1, file_);
+        std::fwrite(&line, sizeof(line), 1, file_);
+        std::fwrite(&file_length, sizeof(file_length), 1, file_);
+        std::fwrite(entry.file.data(), 1, file_length, file_);
+        std::fwrite(&format_length, sizeof(format_length), 1, file_);
+        std::fwrite(entry.format.data(), 1, format_length, file_);
+    }
+}
+
+void BinaryLogSink::flush() {
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        snapshot = buffers_;
+    }
+    
+    for (auto& buffer : snapshot) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        commit(*buffer);
+    }
+    snapshot.clear();
+    
+    {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        if (file_) {
+            std::fflush(file_);
+        }
+    }
+    
+    // 线程退出后只剩本输出持有其缓冲区，写空后释放
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+        if (it->use_count() == 1) {
+            {
+                std::lock_guard<std::mutex> buffer_lock((*it)->mutex);
+                commit(**it);
+            }
+            it = buffers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "binary_log_format.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 日志格式串注册表
+ * 
+ * 每个格式化日志调用点在首次执行时注册一次（调用点内的静态变量），
+ * 之后只以编号引用格式串。编号在进程内全局唯一。
+ */
+class LogFormatRegistry {
+public:
+    /**
+     * @brief 格式定义
+     */
+    struct Entry {
+        uint8_t level;
+        int line;
+        std::string file;
+        std::string format;
+    };
+    
+    /**
+     * @brief 获取全局注册表
+     * @return 注册表
+     */
+    static LogFormatRegistry& instance();
+    
+    /**
+     * @brief 注册格式串
+     * @param level 日志级别
+     * @param format 格式串（"{}" 为参数占位符）
+     * @param file 文件名
+     * @param line 行号
+     * @return 格式编号
+     */
+    uint32_t add(uint8_t level, const char* format, const char* file, int line);
+    
+    /**
+     * @brief 获取已注册的格式数
+     * @return 格式数
+     */
+    size_t size() const;
+    
+    /**
+     * @brief 获取格式定义
+     * @param id 格式编号
+     * @param entry 输出定义
+     * @return 是否存在
+     */
+    bool get(uint32_t id, Entry& entry) const;
+
+private:
+    LogFormatRegistry() = default;
+    
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+namespace binary_log {
+
+// ==================== 参数编码 ====================
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value, size_t>::type
+encodedSize(const T&) {
+    return 1 + 8;
+}
+
+inline size_t encodedSize(const char* value) {
+    return 1 + 4 + (value ? std::strlen(value) : 0);
+}
+
+inline size_t encodedSize(const std::string& value) {
+    return 1 + 4 + value.size();
+}
+
+inline size_t encodedArgsSize() {
+    return 0;
+}
+
+template <typename T, typename... Rest>
+inline size_t encodedArgsSize(const T& value, const Rest&... rest) {
+    return encodedSize(value) + encodedArgsSize(rest...);
+}
+
+template <typename T>
+inline void writeRaw(char*& out, const T& value) {
+    std::memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+encode(char*& out, const T& value) {
+    *out++ = kArgInt;
+    writeRaw(out, static_cast<int64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+encode(char*& out, const T& value) {
+    *out++ = kArgUint;
+    writeRaw(out, static_cast<uint64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+encode(char*& out, const T& value) {
+    *out++ = kArgDouble;
+    writeRaw(out, static_cast<double>(value));
+}
+
+inline void encodeString(char*& out, const char* data, uint32_t length) {
+    *out++ = kArgString;
+    writeRaw(out, length);
+    if (length > 0) {
+        std::memcpy(out, data, length);
+        out += length;
+    }
+}
+
+inline void encode(char*& out, const char* value) {
+    encodeString(out, value, value ? static_cast<uint32_t>(std::strlen(value)) : 0);
+}
+
+inline void encode(char*& out, const std::string& value) {
+    encodeString(out, value.data(), static_cast<uint32_t>(value.size()));
+}
+
+inline void encodeArgs(char*&) {
+}
+
+template <typename T, typename... Rest>
+inline void encodeArgs(char*& out, const T& value, const Rest&... rest) {
+    encode(out, value);
+    encodeArgs(out, rest...);
+}
+
+// ==================== 文本格式化（未启用二进制日志时使用） ====================
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value, std::string>::type
+toText(const T& value) {
+    return std::to_string(value);
+}
+
+inline std::string toText(const char* value) {
+    return value ? std::string(value) : std::string();
+}
+
+inline std::string toText(const std::string& value) {
+    return value;
+}
+
+inline void collectText(std::string*) {
+}
+
+template <typename T, typename... Rest>
+inline void collectText(std::string* out, const T& value, const Rest&... rest) {
+    *out = toText(value);
+    collectText(out + 1, rest...);
+}
+
+/**
+ * @brief 在调用线程格式化日志文本
+ * @param format 格式串
+ * @param args 参数
+ * @return 格式化结果
+ */
+template <typename... Args>
+inline std::string formatText(const char* format, const Args&... args) {
+    std::string texts[sizeof...(Args) + 1];
+    collectText(texts, args...);
+    return substitute(format, texts, sizeof...(Args));
+}
+
+} // namespace binary_log
+
+/**
+ * @brief 二进制日志输出
+ * 
+ * 调用线程只把格式编号、时间戳和参数的原始字节追加到本线程的缓冲区（仅一次无竞争加锁），
+ * 不做任何文本格式化；缓冲区写满、flush 或关闭时整块写入文件。
+ * 文本由离线解码工具按格式定义还原。
+ */
+class BinaryLogSink {
+public:
+    /**
+     * @brief 构造函数
+     * @param buffer_size 每个线程的缓冲区大小（字节）
+     */
+    explicit BinaryLogSink(size_t buffer_size = 64 * 1024);
+    
+    /**
+     * @brief 析构函数（关闭文件）
+     */
+    ~BinaryLogSink();
+    
+    BinaryLogSink(const BinaryLogSink&) = delete;
+    BinaryLogSink& operator=(const BinaryLogSink&) = delete;
+    
+    /**
+     * @brief 打开（截断）日志文件并写入文件头
+     * @param path 文件路径
+     * @return 是否成功
+     */
+    bool open(const std::string& path);
+    
+    /**
+     * @brief 写出所有缓冲区并关闭文件
+     * 
+     * 同时释放各线程在本输出上的缓冲区；线程本地的登记项在该线程下次写日志时清除。
+     */
+    void close();
+    
+    /**
+     * @brief 检查是否已打开
+     * @return 是否打开
+     */
+    bool isOpen() const { return open_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief 写入一条日志记录
+     * @param format_id 格式编号
+     * @param args 参数（整数、浮点数、C 字符串或 std::string）
+     */
+    template <typename... Args>
+    void write(uint32_t format_id, const Args&... args) {
+        size_t size = kEntryHeaderSize + binary_log::encodedArgsSize(args...);
+        uint64_t timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        
+        ThreadBuffer* buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (!buffer->data) {
+            return;  // 输出已关闭，缓冲区已释放
+        }
+        if (buffer->used + size > buffer_size_) {
+            commit(*buffer);
+            if (size > buffer_size_) {
+                records_dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        
+        char* out = buffer->data.get() + buffer->used;
+        *out++ = binary_log::kRecordEntry;
+        binary_log::writeRaw(out, format_id);
+        binary_log::writeRaw(out, timestamp);
+        binary_log::writeRaw(out, buffer->thread_index);
+        *out++ = static_cast<char>(sizeof...(Args));
+        binary_log::encodeArgs(out, args...);
+        buffer->used += size;
+    }
+    
+    /**
+     * @brief 把所有线程的缓冲区写入文件
+     */
+    void flush();
+    
+    /**
+     * @brief 获取因单条记录超过缓冲区大小而丢弃的记录数
+     * @return 丢弃数
+     */
+    uint64_t getDroppedCount() const { return records_dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // 记录头：类型(1) + 格式编号(4) + 时间戳(8) + 线程(4) + 参数个数(1)
+    static const size_t kEntryHeaderSize = 1 + 4 + 8 + 4 + 1;
+    
+    /**
+     * @brief 线程缓冲区（只被所属线程写入，flush/close 时由其他线程加锁读出）
+     */
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::unique_ptr<char[]> data;
+        size_t used;
+        uint32_t thread_index;
+        std::atomic<bool> retired;  // 输出已关闭，线程本地登记项应被清除
+        
+        ThreadBuffer() : used(0), thread_index(0), retired(false) {}
+    };
+    
+    /**
+     * @brief 获取当前线程在本输出上的缓冲区，首次调用时创建并登记
+     * @return 缓冲区
+     */
+    ThreadBuffer* threadBuffer();
+    
+    /**
+     * @brief 释放所有已登记的线程缓冲区并标记为已退役
+     */
+    void retireBuffers();
+    
+    /**
+     * @brief 把缓冲区内容写入文件（调用方持有 buffer.mutex）
+     * @param buffer 缓冲区
+     */
+    void commit(ThreadBuffer& buffer);
+    
+    /**
+     * @brief 写出尚未写入文件的格式定义（调用方持有 file_mutex_）
+     */
+    void writeDefinitions();
+    
+    const uint64_t sink_id_;
+    const size_t buffer_size_;
+    std::atomic<bool> open_;
+    std::atomic<uint64_t> records_dropped_;
+    
+    std::mutex file_mutex_;
+    FILE* file_;
+    size_t definitions_written_;
+    
+    std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    uint32_t next_thread_index_;
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cross_platform_websocket {
+namespace binary_log {
+
+/**
+ * 二进制日志文件格式（字段按本机字节序写入，解码需在相同字节序的机器上进行）
+ *
+ * 文件头：    magic "WSBL"(4) | version(u32)
+ * 格式定义：  'D' | id(u32) | level(u8) | line(u32) | file_len(u16) | file | format_len(u32) | format
+ * 日志记录：  'E' | id(u32) | timestamp_ns(u64) | thread(u32) | argc(u8) | 参数...
+ * 参数：      'i' int64 | 'u' uint64 | 'd' double | 's' len(u32) + 字节
+ *
+ * 格式串中的 "{}" 依次替换为参数；格式定义在首次写出引用它的记录之前写入。
+ */
+static const char kMagic[4] = { 'W', 'S', 'B', 'L' };
+static const uint32_t kVersion = 1;
+
+static const char kRecordDefinition = 'D';
+static const char kRecordEntry = 'E';
+
+static const char kArgInt = 'i';
+static const char kArgUint = 'u';
+static const char kArgDouble = 'd';
+static const char kArgString = 's';
+
+/**
+ * @brief 把格式串中的 "{}" 依次替换为参数文本
+ * @param format 格式串
+ * @param args 参数文本
+ * @param argc 参数个数
+ * @return 格式化结果（多余的参数被忽略，缺少的参数保留 "{}"）
+ */
+inline std::string substitute(const std::string& format, const std::string* args, size_t argc) {
+    std::string result;
+    result.reserve(format.size() + argc * 8);
+
+    size_t next = 0;
+    size_t position = 0;
+    while (position < format.size()) {
+        size_t placeholder = format.find("{}", position);
+        if (placeholder == std::string::npos || next >= argc) {
+            result.append(format, position, std::string::npos);
+            break;
+        }
+        result.append(format, position, placeholder - position);
+        result.append(args[next++]);
+        position = placeholder + 2;
+    }
+    return result;
+}
+
+} // namespace binary_log
+} // namespace cross_platform_websocket
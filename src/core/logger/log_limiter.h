@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../ratelimit/token_bucket.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 单个日志调用点的采样和限速状态
+ * 
+ * 由 LOG_*_EVERY_N / LOG_*_RATE 宏在调用点内以静态变量创建：
+ * 先按 1/N 采样，再经令牌桶限速，被拦下的行只计数，
+ * 下一次放行时把累计的抑制行数附在消息后面报告。
+ * 被拦下时消息参数不求值，开销为一次原子自增和一次令牌桶 CAS。
+ */
+class LogSiteLimiter {
+public:
+    /**
+     * @brief 构造函数
+     * @param every_n 每 N 次调用输出一次（0 或 1 表示不采样）
+     * @param rate_per_second 每秒最多输出的行数（0 表示不限速，突发容量为一秒的量）
+     */
+    LogSiteLimiter(uint32_t every_n, double rate_per_second)
+        : every_n_(every_n > 1 ? every_n : 1)
+        , calls_(0)
+        , pending_suppressed_(0) {
+        bucket_.configure(rate_per_second, rate_per_second);
+    }
+    
+    LogSiteLimiter(const LogSiteLimiter&) = delete;
+    LogSiteLimiter& operator=(const LogSiteLimiter&) = delete;
+    
+    /**
+     * @brief 判断本次调用是否输出
+     * @param suppressed 放行时输出自上次放行以来被抑制的行数
+     * @return 是否输出
+     */
+    bool allow(uint64_t& suppressed) {
+        if (every_n_ > 1 && calls_.fetch_add(1, std::memory_order_relaxed) % every_n_ != 0) {
+            pending_suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (!bucket_.tryAcquire()) {
+            pending_suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = pending_suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    
+    /**
+     * @brief 在消息后附加抑制行数
+     * @param message 日志消息
+     * @param suppressed 抑制行数
+     * @return 附加后的消息
+     */
+    static std::string annotate(std::string message, uint64_t suppressed) {
+        if (suppressed > 0) {
+            message += "（此处已抑制 " + std::to_string(suppressed) + " 条）";
+        }
+        return message;
+    }
+
+private:
+    const uint32_t every_n_;
+    std::atomic<uint64_t> calls_;
+    std::atomic<uint64_t> pending_suppressed_;
+    TokenBucket bucket_;
+};
+
+} // namespace cross_platform_websocket
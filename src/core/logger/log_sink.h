@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cross_platform_websocket {
+
+enum class LogLevel;
+
+/**
+ * @brief 日志输出目标
+ * 
+ * Logger 把格式化后的每一行交给所有已注册的输出目标。同步模式下 write 可能被多个
+ * 调用线程并发调用，异步模式下只由后台写线程调用；实现需自行保证线程安全，
+ * 且不应在 write 中阻塞。
+ */
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    
+    /**
+     * @brief 写入一行日志
+     * @param level 日志级别
+     * @param text 已格式化的日志（不含换行符）
+     * @param length 长度
+     */
+    virtual void write(LogLevel level, const char* text, size_t length) = 0;
+    
+    /**
+     * @brief 一批日志写完后调用（同步模式下每行一次，异步模式下每批一次）
+     */
+    virtual void flush() {}
+};
+
+} // namespace cross_platform_websocket
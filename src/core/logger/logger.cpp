@@ -1,91 +1,396 @@
 #include "logger.h"
-#include <sstream>
-#include <iomanip>
 #include <chrono>
+#include <ctime>
+#include <thread>
 
 namespace cross_platform_websocket {
 
+// 后台线程每批最多输出的记录数
+static const size_t kWriteBatchSize = 256;
+
+// 后台线程空闲时的最长等待时间（毫秒），兜底未被唤醒的情况
+static const int kWriterIdleWaitMs = 50;
+
 // 全局日志实例
 std::shared_ptr<Logger> g_logger;
 
 Logger::Logger(std::shared_ptr<PlatformInterface> platform)
     : platform_(platform)
-    , current_level_(LogLevel::INFO) {
+    , overflow_policy_(LogOverflowPolicy::DROP)
+    , async_enabled_(false)
+    , async_running_(false)
+    , active_producers_(0)
+    , writer_waiting_(false)
+    , records_queued_(0)
+    , records_written_(0)
+    , writer_thread_(nullptr)
+    , console_output_(true)
+    , has_sinks_(false)
+    , sinks_(std::make_shared<std::vector<std::shared_ptr<LogSink>>>())
+    , binary_sink_(new BinaryLogSink()) {
+    setLogLevel(LogLevel::INFO);
+}
+
+Logger::~Logger() {
+    stopAsync();
+    binary_sink_->close();
 }
 
 void Logger::setLogLevel(LogLevel level) {
-    current_level_ = level;
+    for (size_t i = 0; i < kLogModuleCount; ++i) {
+        setModuleLevel(static_cast<LogModule>(i), level);
+    }
 }
 
 LogLevel Logger::getLogLevel() const {
-    return current_level_;
+    return getModuleLevel(LogModule::GENERAL);
+}
+
+void Logger::setModuleLevel(LogModule module, LogLevel level) {
+    size_t index = static_cast<size_t>(module);
+    if (index >= kLogModuleCount) {
+        return;
+    }
+    
+    module_levels_[index].store(static_cast<int>(level), std::memory_order_relaxed);
+    if (module == LogModule::PLATFORM && platform_) {
+        platform_->setInternalLogLevel(static_cast<int>(level));
+    }
+}
+
+LogLevel Logger::getModuleLevel(LogModule module) const {
+    size_t index = static_cast<size_t>(module);
+    if (index >= kLogModuleCount) {
+        return LogLevel::OFF;
+    }
+    return static_cast<LogLevel>(module_levels_[index].load(std::memory_order_relaxed));
+}
+
+bool Logger::enableAsync(bool enabled, size_t capacity, LogOverflowPolicy policy) {
+    if (!enabled) {
+        stopAsync();
+        return true;
+    }
+    
+    std::lock_guard<std::mutex> control(control_mutex_);
+    overflow_policy_ = policy;
+    if (async_running_) {
+        return true;
+    }
+    
+    if (!ring_) {
+        ring_ = std::unique_ptr<MpscRing<LogRecord>>(new MpscRing<LogRecord>(capacity));
+    }
+    
+    async_running_ = true;
+    writer_thread_ = platform_->createThread(&Logger::writerThreadEntry, this);
+    if (!writer_thread_) {
+        async_running_ = false;
+        return false;
+    }
+    async_enabled_ = true;
+    return true;
+}
+
+bool Logger::isAsync() const {
+    return async_enabled_;
+}
+
+uint64_t Logger::getDroppedCount() const {
+    return stats_.get(STAT_DROPPED);
+}
+
+void Logger::addSink(std::shared_ptr<LogSink> sink) {
+    if (!sink) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    auto sinks = std::make_shared<std::vector<std::shared_ptr<LogSink>>>(*std::atomic_load(&sinks_));
+    sinks->push_back(std::move(sink));
+    std::atomic_store(&sinks_, std::shared_ptr<const std::vector<std::shared_ptr<LogSink>>>(sinks));
+    has_sinks_ = true;
+}
+
+void Logger::removeSink(const std::shared_ptr<LogSink>& sink) {
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    auto sinks = std::make_shared<std::vector<std::shared_ptr<LogSink>>>(*std::atomic_load(&sinks_));
+    for (auto it = sinks->begin(); it != sinks->end(); ++it) {
+        if (*it == sink) {
+            sinks->erase(it);
+            break;
+        }
+    }
+    has_sinks_ = !sinks->empty();
+    std::atomic_store(&sinks_, std::shared_ptr<const std::vector<std::shared_ptr<LogSink>>>(sinks));
+}
+
+void Logger::setConsoleOutput(bool enabled) {
+    console_output_ = enabled;
+}
+
+bool Logger::enableBinaryLog(const std::string& path) {
+    return binary_sink_->open(path);
+}
+
+void Logger::disableBinaryLog() {
+    binary_sink_->close();
+}
+
+void Logger::flush() {
+    if (binary_sink_->isOpen()) {
+        binary_sink_->flush();
+    }
+    
+    if (!async_running_) {
+        return;
+    }
+    
+    uint64_t target = records_queued_;
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    async_cv_.notify_one();
+    flushed_cv_.wait(lock, [this, target]() {
+        return records_written_ >= target || !async_running_;
+    });
+}
+
+void Logger::stopAsync() {
+    std::lock_guard<std::mutex> control(control_mutex_);
+    if (!async_running_) {
+        return;
+    }
+    
+    // 先拒绝新记录，再等待正在写入的调用线程离开，保证后台线程退出后队列不再增长
+    async_enabled_ = false;
+    while (active_producers_ > 0) {
+        std::this_thread::yield();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        async_running_ = false;
+    }
+    async_cv_.notify_all();
+    platform_->joinThread(writer_thread_);
+    writer_thread_ = nullptr;
+    
+    if (writeBatch(static_cast<size_t>(-1)) > 0) {
+        flushOutputs();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+    }
+    flushed_cv_.notify_all();
 }
 
 void Logger::debug(const std::string& message, const std::string& file, int line) {
-    if (shouldLog(LogLevel::DEBUG)) {
-        std::string formatted = formatMessage(LogLevel::DEBUG, message, file, line);
-        platform_->logDebug(formatted);
+    if (isEnabled(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, message, file, line);
     }
 }
 
 void Logger::info(const std::string& message, const std::string& file, int line) {
-    if (shouldLog(LogLevel::INFO)) {
-        std::string formatted = formatMessage(LogLevel::INFO, message, file, line);
-        platform_->logInfo(formatted);
+    if (isEnabled(LogLevel::INFO)) {
+        log(LogLevel::INFO, message, file, line);
     }
 }
 
 void Logger::warning(const std::string& message, const std::string& file, int line) {
-    if (shouldLog(LogLevel::WARNING)) {
-        std::string formatted = formatMessage(LogLevel::WARNING, message, file, line);
-        platform_->logWarning(formatted);
+    if (isEnabled(LogLevel::WARNING)) {
+        log(LogLevel::WARNING, message, file, line);
     }
 }
 
 void Logger::error(const std::string& message, const std::string& file, int line) {
-    if (shouldLog(LogLevel::ERROR)) {
-        std::string formatted = formatMessage(LogLevel::ERROR, message, file, line);
-        platform_->logError(formatted);
+    if (isEnabled(LogLevel::ERROR)) {
+        log(LogLevel::ERROR, message, file, line);
+    }
+}
+
+void Logger::log(LogLevel level, const std::string& message, const std::string& file, int line) {
+    auto now = std::chrono::system_clock::now();
+    if (async_enabled_) {
+        // 调用线程只记录时间并复制消息，格式化和输出交给后台线程
+        LogRecord record;
+        record.level = level;
+        record.message = message;
+        record.file = file;
+        record.line = line;
+        record.time = now;
+        if (enqueue(std::move(record))) {
+            return;
+        }
+    }
+    
+    output(level, format(level, message, file, line, now));
+    flushOutputs();
+}
+
+bool Logger::enqueue(LogRecord&& record) {
+    active_producers_++;
+    if (!async_enabled_) {
+        active_producers_--;
+        return false;
+    }
+    
+    bool pushed = ring_->tryPush(std::move(record));
+    if (!pushed && overflow_policy_ == LogOverflowPolicy::BLOCK) {
+        // 队列满时唤醒后台线程并让出时间片，直到腾出空间或异步模式被关闭
+        while (!pushed && async_enabled_) {
+            async_cv_.notify_one();
+            std::this_thread::yield();
+            pushed = ring_->tryPush(std::move(record));
+        }
+    }
+    
+    if (pushed) {
+        records_queued_++;
+        if (writer_waiting_) {
+            async_cv_.notify_one();
+        }
+    }
+    active_producers_--;
+    
+    if (!pushed && overflow_policy_ == LogOverflowPolicy::DROP) {
+        stats_.add(STAT_DROPPED);
+        return true;
+    }
+    return pushed;
+}
+
+size_t Logger::writeBatch(size_t max_records) {
+    size_t count = 0;
+    LogRecord record;
+    while (count < max_records && ring_ && ring_->tryPop(record)) {
+        output(record.level, format(record.level, record.message, record.file,
+                                    record.line, record.time));
+        count++;
+    }
+    records_written_ += count;
+    return count;
+}
+
+void Logger::writerThreadEntry(void* arg) {
+    static_cast<Logger*>(arg)->writerLoop();
+}
+
+void Logger::writerLoop() {
+    while (true) {
+        // 每批只刷新一次，避免逐条系统调用
+        if (writeBatch(kWriteBatchSize) > 0) {
+            flushOutputs();
+            {
+                std::lock_guard<std::mutex> lock(async_mutex_);
+            }
+            flushed_cv_.notify_all();
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(async_mutex_);
+        if (!async_running_) {
+            break;
+        }
+        writer_waiting_ = true;
+        async_cv_.wait_for(lock, std::chrono::milliseconds(kWriterIdleWaitMs));
+        writer_waiting_ = false;
+    }
+}
+
+void Logger::output(LogLevel level, const std::string& text) {
+    if (console_output_) {
+        switch (level) {
+            case LogLevel::DEBUG:   platform_->logDebug(text); break;
+            case LogLevel::INFO:    platform_->logInfo(text); break;
+            case LogLevel::WARNING: platform_->logWarning(text); break;
+            case LogLevel::ERROR:   platform_->logError(text); break;
+            case LogLevel::OFF:     break;
+        }
+    }
+    
+    if (has_sinks_) {
+        auto sinks = std::atomic_load(&sinks_);
+        for (const auto& sink : *sinks) {
+            sink->write(level, text.data(), text.size());
+        }
+    }
+}
+
+void Logger::flushOutputs() {
+    if (console_output_) {
+        platform_->logFlush();
+    }
+    
+    if (has_sinks_) {
+        auto sinks = std::atomic_load(&sinks_);
+        for (const auto& sink : *sinks) {
+            sink->flush();
+        }
     }
 }
 
 std::string Logger::formatMessage(LogLevel level, const std::string& message, 
                                  const std::string& file, int line) {
-    std::ostringstream oss;
+    return format(level, message, file, line, std::chrono::system_clock::now());
+}
+
+std::string Logger::format(LogLevel level, const std::string& message, const std::string& file,
+                           int line, std::chrono::system_clock::time_point now) const {
+    // 每个线程缓存当前秒的日期时间前缀，同一秒内的记录只追加毫秒，
+    // 秒变化时才调用可重入的 localtime_r/localtime_s（std::localtime 非线程安全且在 glibc 中加锁）
+    struct SecondCache {
+        std::time_t second;
+        size_t length;
+        char prefix[32];
+    };
+    static thread_local SecondCache cache = { static_cast<std::time_t>(-1), 0, { 0 } };
     
-    // 获取当前时间
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+    std::time_t second = std::chrono::system_clock::to_time_t(now);
+    if (second != cache.second) {
+        std::tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &second);
+#else
+        localtime_r(&second, &tm);
+#endif
+        cache.length = std::strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%d %H:%M:%S", &tm);
+        cache.second = second;
+    }
+    
+    int ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()).count() % 1000);
+    const char millis[4] = { '.', static_cast<char>('0' + ms / 100),
+                             static_cast<char>('0' + ms / 10 % 10), static_cast<char>('0' + ms % 10) };
     
-    std::tm* tm = std::localtime(&time_t);
+    std::string result;
+    result.reserve(cache.length + sizeof(millis) + 12 + file.size() + 16 + message.size());
     
-    // 格式化时间戳
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
-    oss << "." << std::setfill('0') << std::setw(3) << ms.count();
+    // 记录时间
+    result.append(cache.prefix, cache.length);
+    result.append(millis, sizeof(millis));
     
     // 添加日志级别
-    oss << " [" << getLevelString(level) << "] ";
+    result += " [";
+    result += getLevelString(level);
+    result += "] ";
     
-    // 添加文件位置信息
+    // 添加文件位置信息（日志宏在编译期已去掉目录，这里只处理直接调用传入的完整路径）
     if (!file.empty() && line > 0) {
         size_t pos = file.find_last_of("/\\");
-        std::string filename = (pos != std::string::npos) ? file.substr(pos + 1) : file;
-        oss << "[" << filename << ":" << line << "] ";
+        result += '[';
+        result.append(file, pos != std::string::npos ? pos + 1 : 0, std::string::npos);
+        result += ':';
+        result += std::to_string(line);
+        result += "] ";
     }
     
     // 添加消息内容
-    oss << message;
+    result += message;
     
-    return oss.str();
-}
-
-bool Logger::shouldLog(LogLevel level) const {
-    return static_cast<int>(level) >= static_cast<int>(current_level_);
+    return result;
 }
 
-std::string Logger::getLevelString(LogLevel level) const {
+const char* Logger::getLevelString(LogLevel level) const {
     switch (level) {
         case LogLevel::DEBUG:   return "DEBUG";
         case LogLevel::INFO:    return "INFO";
@@ -1,8 +1,18 @@
 #pragma once
 
 #include "../../platform/platform_interface.h"
+#include "../container/mpsc_ring.h"
+#include "binary_log.h"
+#include "log_limiter.h"
+#include "log_sink.h"
+#include "../metrics/sharded_counter.h"
 #include <string>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 
 namespace cross_platform_websocket {
 
@@ -13,13 +23,50 @@ enum class LogLevel {
     DEBUG = 0,
     INFO = 1,
     WARNING = 2,
-    ERROR = 3
+    ERROR = 3,
+    OFF = 4     // 仅用于设置级别，关闭输出
+};
+
+/**
+ * @brief 日志模块（每个模块的级别可单独设置）
+ */
+enum class LogModule {
+    GENERAL = 0,    // 不属于下列模块的日志（经全局 g_logger 输出）
+    API = 1,
+    MANAGER = 2,
+    DATALINK = 3,
+    PLATFORM = 4    // 平台实现内部的日志，级别转交 PlatformInterface::setInternalLogLevel
+};
+
+static const size_t kLogModuleCount = 5;
+
+/**
+ * @brief 异步日志队列满时的处理策略
+ */
+enum class LogOverflowPolicy {
+    DROP = 0,   // 丢弃并计数
+    BLOCK = 1   // 等待后台线程腾出空间
+};
+
+/**
+ * @brief 日志记录（异步模式下由调用线程生成，后台线程格式化）
+ */
+struct LogRecord {
+    LogLevel level;
+    std::string message;
+    std::string file;
+    int line;
+    std::chrono::system_clock::time_point time;
+    
+    LogRecord() : level(LogLevel::INFO), line(0) {}
 };
 
 /**
  * @brief 日志库类
  * 
- * 提供统一的日志记录功能，支持不同级别的日志输出
+ * 提供统一的日志记录功能，支持不同级别的日志输出。
+ * 同步模式下在调用线程格式化并逐条输出；异步模式下调用线程只把记录写入无锁队列，
+ * 由后台线程批量格式化、输出，每批只刷新一次。
  */
 class Logger {
 public:
@@ -32,22 +79,179 @@ public:
     /**
      * @brief 析构函数
      */
-    ~Logger() = default;
+    ~Logger();
     
     /**
-     * @brief 设置日志级别
+     * @brief 设置所有模块的日志级别
      * @param level 日志级别
      */
     void setLogLevel(LogLevel level);
     
     /**
-     * @brief 获取当前日志级别
+     * @brief 获取 GENERAL 模块的日志级别
      * @return 日志级别
      */
     LogLevel getLogLevel() const;
     
     /**
-     * @brief 记录调试日志
+     * @brief 设置单个模块的日志级别
+     * @param module 模块
+     * @param level 日志级别（OFF 表示关闭）
+     */
+    void setModuleLevel(LogModule module, LogLevel level);
+    
+    /**
+     * @brief 获取单个模块的日志级别
+     * @param module 模块
+     * @return 日志级别
+     */
+    LogLevel getModuleLevel(LogModule module) const;
+    
+    /**
+     * @brief 检查指定模块、指定级别的日志是否会输出
+     * 
+     * 日志宏先调用本函数（一次 relaxed 原子读），级别不够时不再求值消息参数。
+     * 
+     * @param module 模块
+     * @param level 日志级别
+     * @return 是否输出
+     */
+    bool isEnabled(LogModule module, LogLevel level) const {
+        return static_cast<int>(level) >=
+               module_levels_[static_cast<size_t>(module)].load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief 检查 GENERAL 模块指定级别的日志是否会输出
+     * @param level 日志级别
+     * @return 是否输出
+     */
+    bool isEnabled(LogLevel level) const {
+        return isEnabled(LogModule::GENERAL, level);
+    }
+    
+    /**
+     * @brief 启用或关闭异步日志
+     * 
+     * 关闭时等待后台线程输出队列中剩余的记录后返回。
+     * 
+     * @param enabled 是否启用
+     * @param capacity 队列容量（条，向上取整为 2 的幂，仅在队列创建时生效）
+     * @param policy 队列满时的处理策略
+     * @return 是否成功（后台线程创建失败时返回 false 并保持同步模式）
+     */
+    bool enableAsync(bool enabled, size_t capacity = 8192,
+                     LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+    
+    /**
+     * @brief 检查是否处于异步模式
+     * @return 是否异步
+     */
+    bool isAsync() const;
+    
+    /**
+     * @brief 获取因队列满而丢弃的记录数
+     * @return 丢弃数
+     */
+    uint64_t getDroppedCount() const;
+    
+    /**
+     * @brief 累计被采样或限速抑制的日志行数（由调用点在下一次放行时报告）
+     * @param count 抑制行数
+     */
+    void noteSuppressed(uint64_t count) {
+        stats_.add(STAT_SUPPRESSED, count);
+    }
+    
+    /**
+     * @brief 获取已报告的被抑制日志行数
+     * @return 抑制行数
+     */
+    uint64_t getSuppressedCount() const {
+        return stats_.get(STAT_SUPPRESSED);
+    }
+    
+    /**
+     * @brief 等待此前提交的异步记录全部输出，并写出二进制日志的线程缓冲区
+     */
+    void flush();
+    
+    /**
+     * @brief 添加日志输出目标（每行日志在控制台之外再写入该目标）
+     * @param sink 输出目标
+     */
+    void addSink(std::shared_ptr<LogSink> sink);
+    
+    /**
+     * @brief 移除日志输出目标
+     * 
+     * 返回后同步模式下仍可能有正在进行的写入；异步模式下调用方应先 flush。
+     * 
+     * @param sink 输出目标
+     */
+    void removeSink(const std::shared_ptr<LogSink>& sink);
+    
+    /**
+     * @brief 设置是否输出到平台控制台
+     * @param enabled 是否输出
+     */
+    void setConsoleOutput(bool enabled);
+    
+    /**
+     * @brief 启用二进制日志
+     * 
+     * 启用后 LOG_*F 宏只把格式编号和参数原始字节写入线程缓冲区，
+     * 文本由 ws_log_decode 工具离线还原；LOG_* 宏不受影响。
+     * 
+     * @param path 日志文件路径（已存在时截断）
+     * @return 是否成功
+     */
+    bool enableBinaryLog(const std::string& path);
+    
+    /**
+     * @brief 关闭二进制日志（写出所有线程缓冲区后关闭文件）
+     */
+    void disableBinaryLog();
+    
+    /**
+     * @brief 检查是否启用二进制日志
+     * @return 是否启用
+     */
+    bool isBinaryLog() const { return binary_sink_->isOpen(); }
+    
+    /**
+     * @brief 记录格式化日志（LOG_*F 宏使用）
+     * 
+     * 启用二进制日志时只写入格式编号和参数；否则在调用线程格式化后按普通日志输出。
+     * 
+     * @param format_id 格式编号（由 LogFormatRegistry 分配）
+     * @param level 日志级别
+     * @param file 文件名
+     * @param line 行号
+     * @param format 格式串（"{}" 为参数占位符）
+     * @param args 参数
+     */
+    template <typename... Args>
+    void logFormat(uint32_t format_id, LogLevel level, const char* file, int line,
+                   const char* format, const Args&... args) {
+        if (binary_sink_->isOpen()) {
+            binary_sink_->write(format_id, args...);
+            return;
+        }
+        log(level, binary_log::formatText(format, args...), file, line);
+    }
+    
+    /**
+     * @brief 记录一条日志（不再检查级别，由调用方先调用 isEnabled）
+     * @param level 日志级别
+     * @param message 日志消息
+     * @param file 文件名
+     * @param line 行号
+     */
+    void log(LogLevel level, const std::string& message, const std::string& file, int line);
+    
+    /**
+     * @brief 记录调试日志（按 GENERAL 模块的级别过滤）
      * @param message 日志消息
      * @param file 文件名（可选）
      * @param line 行号（可选）
@@ -55,7 +259,7 @@ public:
     void debug(const std::string& message, const std::string& file = "", int line = 0);
     
     /**
-     * @brief 记录信息日志
+     * @brief 记录信息日志（按 GENERAL 模块的级别过滤）
      * @param message 日志消息
      * @param file 文件名（可选）
      * @param line 行号（可选）
@@ -63,7 +267,7 @@ public:
     void info(const std::string& message, const std::string& file = "", int line = 0);
     
     /**
-     * @brief 记录警告日志
+     * @brief 记录警告日志（按 GENERAL 模块的级别过滤）
      * @param message 日志消息
      * @param file 文件名（可选）
      * @param line 行号（可选）
@@ -71,7 +275,7 @@ public:
     void warning(const std::string& message, const std::string& file = "", int line = 0);
     
     /**
-     * @brief 记录错误日志
+     * @brief 记录错误日志（按 GENERAL 模块的级别过滤）
      * @param message 日志消息
      * @param file 文件名（可选）
      * @param line 行号（可选）
@@ -91,30 +295,227 @@ public:
 
 private:
     std::shared_ptr<PlatformInterface> platform_;
-    LogLevel current_level_;
+    std::atomic<int> module_levels_[kLogModuleCount];
+    
+    // 异步模式
+    std::unique_ptr<MpscRing<LogRecord>> ring_;
+    std::atomic<LogOverflowPolicy> overflow_policy_;
+    std::atomic<bool> async_enabled_;
+    std::atomic<bool> async_running_;
+    std::atomic<int> active_producers_;     // 正在写入队列的调用线程数
+    std::atomic<bool> writer_waiting_;      // 后台线程是否在等待新记录
+    std::atomic<uint64_t> records_queued_;
+    std::atomic<uint64_t> records_written_;
+    
+    // 丢弃和抑制计数由所有调用线程更新，按线程分片计数
+    enum StatCounter {
+        STAT_DROPPED,
+        STAT_SUPPRESSED,
+        STAT_COUNT
+    };
+    ShardedCounters<STAT_COUNT> stats_;
+    
+    std::mutex control_mutex_;              // 串行化异步模式的开启和关闭
+    std::mutex async_mutex_;                // 后台线程等待新记录、flush 等待输出
+    std::condition_variable async_cv_;
+    std::condition_variable flushed_cv_;
+    void* writer_thread_;
+    
+    // 输出目标：写时复制，写日志时只读取快照
+    std::atomic<bool> console_output_;
+    std::atomic<bool> has_sinks_;
+    std::mutex sinks_mutex_;                // 串行化输出目标的增删
+    std::shared_ptr<const std::vector<std::shared_ptr<LogSink>>> sinks_;
+    
+    // 二进制日志（常驻，启用与否由文件是否打开决定）
+    std::unique_ptr<BinaryLogSink> binary_sink_;
+    
+    /**
+     * @brief 把记录写入异步队列
+     * @param record 日志记录
+     * @return 是否已写入（未处于异步模式时返回 false，由调用方同步输出）
+     */
+    bool enqueue(LogRecord&& record);
+    
+    /**
+     * @brief 按级别把已格式化的消息交给平台和各输出目标（不刷新）
+     * @param level 日志级别
+     * @param text 已格式化的消息
+     */
+    void output(LogLevel level, const std::string& text);
+    
+    /**
+     * @brief 一批日志输出完后刷新平台和各输出目标
+     */
+    void flushOutputs();
     
     /**
-     * @brief 检查是否应该输出指定级别的日志
+     * @brief 格式化日志消息
      * @param level 日志级别
-     * @return 是否应该输出
+     * @param message 原始消息
+     * @param file 文件名
+     * @param line 行号
+     * @param time 记录时间
+     * @return 格式化后的消息
+     */
+    std::string format(LogLevel level, const std::string& message, const std::string& file,
+                       int line, std::chrono::system_clock::time_point time) const;
+    
+    /**
+     * @brief 输出队列中的记录
+     * @param max_records 本批最多输出的记录数
+     * @return 输出的记录数
      */
-    bool shouldLog(LogLevel level) const;
+    size_t writeBatch(size_t max_records);
+    
+    /**
+     * @brief 停止后台线程并输出剩余记录
+     */
+    void stopAsync();
+    
+    static void writerThreadEntry(void* arg);
+    void writerLoop();
     
     /**
      * @brief 获取日志级别字符串
      * @param level 日志级别
      * @return 级别字符串
      */
-    std::string getLevelString(LogLevel level) const;
+    const char* getLevelString(LogLevel level) const;
 };
 
-// 全局日志实例
+// 全局日志实例（不属于任何连接实例的代码使用，见 LogModule::GENERAL）
 extern std::shared_ptr<Logger> g_logger;
 
+/**
+ * @brief 日志宏使用的上下文：写入哪个日志器、按哪个模块的级别过滤
+ */
+struct LogContext {
+    Logger* logger;
+    LogModule module;
+    
+    LogContext(Logger* logger_value, LogModule module_value)
+        : logger(logger_value), module(module_value) {}
+};
+
+/**
+ * @brief 日志上下文查找标记
+ * 
+ * 日志宏以 wsLogContext(LogContextTag()) 获取上下文：在声明了同名成员函数的类
+ * （WebSocketAPI、WebSocketManager、DataLink、ReliableChannel）的成员函数中，
+ * 普通名字查找找到成员，日志写入所属实例的日志器并按该类的模块过滤；
+ * 其他位置经参数相关查找找到下面的全局版本。
+ */
+struct LogContextTag {};
+
+inline LogContext wsLogContext(LogContextTag) {
+    return LogContext(g_logger.get(), LogModule::GENERAL);
+}
+
+/**
+ * @brief 返回路径中最后一个分隔符之后的部分（constexpr，日志宏在编译期求值）
+ * @param path 路径
+ * @param last 当前找到的文件名起点
+ * @return 文件名
+ */
+constexpr const char* logBaseName(const char* path, const char* last) {
+    return *path == '\0' ? last
+         : logBaseName(path + 1, (*path == '/' || *path == '\\') ? path + 1 : last);
+}
+
+constexpr const char* logBaseName(const char* path) {
+    return logBaseName(path, path);
+}
+
+// 编译期日志级别下限（0=DEBUG 1=INFO 2=WARNING 3=ERROR），低于该级别的日志调用
+// 条件恒为假，由编译器整体移除，但参数仍参与编译检查
+#ifndef WS_LOG_MIN_LEVEL
+#define WS_LOG_MIN_LEVEL 0
+#endif
+
+// 取当前位置的日志上下文，级别不够时整条语句只有一次 relaxed 原子读
+#define WS_LOG_CONTEXT_ENABLED(level) \
+    const ::cross_platform_websocket::LogContext ws_log_context = \
+        wsLogContext(::cross_platform_websocket::LogContextTag()); \
+    if (ws_log_context.logger && ws_log_context.logger->isEnabled(ws_log_context.module, level))
+
+// 先检查级别再求值消息参数，级别不够时不拼接字符串；文件名在编译期去掉目录
+#define WS_LOG_AT(level, min_value, msg) \
+    do { \
+        if ((min_value) >= WS_LOG_MIN_LEVEL) { \
+            WS_LOG_CONTEXT_ENABLED(level) { \
+                static constexpr const char* ws_log_file = ::cross_platform_websocket::logBaseName(__FILE__); \
+                ws_log_context.logger->log(level, msg, ws_log_file, __LINE__); \
+            } \
+        } \
+    } while (0)
+
 // 便捷宏定义
-#define LOG_DEBUG(msg) if (g_logger) g_logger->debug(msg, __FILE__, __LINE__)
-#define LOG_INFO(msg) if (g_logger) g_logger->info(msg, __FILE__, __LINE__)
-#define LOG_WARNING(msg) if (g_logger) g_logger->warning(msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) if (g_logger) g_logger->error(msg, __FILE__, __LINE__)
+#define LOG_DEBUG(msg) WS_LOG_AT(::cross_platform_websocket::LogLevel::DEBUG, 0, msg)
+#define LOG_INFO(msg) WS_LOG_AT(::cross_platform_websocket::LogLevel::INFO, 1, msg)
+#define LOG_WARNING(msg) WS_LOG_AT(::cross_platform_websocket::LogLevel::WARNING, 2, msg)
+#define LOG_ERROR(msg) WS_LOG_AT(::cross_platform_websocket::LogLevel::ERROR, 3, msg)
+
+// 每条消息都会经过的调用点（收发路径）的默认限速：每个调用点每秒最多输出的行数
+#ifndef WS_LOG_HOT_PATH_RATE
+#define WS_LOG_HOT_PATH_RATE 10
+#endif
+
+// 采样和限速日志：每个调用点持有独立的 LogSiteLimiter（同一调用点的所有实例共享），
+// 被拦下时不求值消息参数，放行时在消息后附上此前被抑制的行数
+#define WS_LOG_LIMITED_AT(level, min_value, every_n, rate_per_second, msg) \
+    do { \
+        if ((min_value) >= WS_LOG_MIN_LEVEL) { \
+            WS_LOG_CONTEXT_ENABLED(level) { \
+                static constexpr const char* ws_log_file = ::cross_platform_websocket::logBaseName(__FILE__); \
+                static ::cross_platform_websocket::LogSiteLimiter ws_log_limiter((every_n), (rate_per_second)); \
+                uint64_t ws_log_suppressed = 0; \
+                if (ws_log_limiter.allow(ws_log_suppressed)) { \
+                    if (ws_log_suppressed > 0) { \
+                        ws_log_context.logger->noteSuppressed(ws_log_suppressed); \
+                    } \
+                    ws_log_context.logger->log( \
+                        level, ::cross_platform_websocket::LogSiteLimiter::annotate(msg, ws_log_suppressed), \
+                        ws_log_file, __LINE__); \
+                } \
+            } \
+        } \
+    } while (0)
+
+// 每 n 次调用输出一次
+#define LOG_DEBUG_EVERY_N(n, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::DEBUG, 0, n, 0, msg)
+#define LOG_INFO_EVERY_N(n, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::INFO, 1, n, 0, msg)
+#define LOG_WARNING_EVERY_N(n, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::WARNING, 2, n, 0, msg)
+#define LOG_ERROR_EVERY_N(n, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::ERROR, 3, n, 0, msg)
+
+// 每秒最多输出 rate 行
+#define LOG_DEBUG_RATE(rate, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::DEBUG, 0, 1, rate, msg)
+#define LOG_INFO_RATE(rate, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::INFO, 1, 1, rate, msg)
+#define LOG_WARNING_RATE(rate, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::WARNING, 2, 1, rate, msg)
+#define LOG_ERROR_RATE(rate, msg) WS_LOG_LIMITED_AT(::cross_platform_websocket::LogLevel::ERROR, 3, 1, rate, msg)
+
+// 取可变参数中的第一个（格式串），其余参数为空时也不触发 -Wpedantic
+#define WS_LOG_FIRST(...) WS_LOG_FIRST_IMPL(__VA_ARGS__, unused)
+#define WS_LOG_FIRST_IMPL(first, ...) first
+
+// 格式化日志：格式串必须是字面量，每个调用点只在首次执行时注册一次
+#define WS_LOGF_AT(level, min_value, ...) \
+    do { \
+        if ((min_value) >= WS_LOG_MIN_LEVEL) { \
+            WS_LOG_CONTEXT_ENABLED(level) { \
+                static constexpr const char* ws_log_file = ::cross_platform_websocket::logBaseName(__FILE__); \
+                static const uint32_t ws_log_format_id = \
+                    ::cross_platform_websocket::LogFormatRegistry::instance().add( \
+                        static_cast<uint8_t>(level), WS_LOG_FIRST(__VA_ARGS__), ws_log_file, __LINE__); \
+                ws_log_context.logger->logFormat(ws_log_format_id, level, ws_log_file, __LINE__, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+// 格式化日志宏，例如 LOG_INFOF("发送 {} 字节，队列 {}", size, depth)
+#define LOG_DEBUGF(...) WS_LOGF_AT(::cross_platform_websocket::LogLevel::DEBUG, 0, __VA_ARGS__)
+#define LOG_INFOF(...) WS_LOGF_AT(::cross_platform_websocket::LogLevel::INFO, 1, __VA_ARGS__)
+#define LOG_WARNINGF(...) WS_LOGF_AT(::cross_platform_websocket::LogLevel::WARNING, 2, __VA_ARGS__)
+#define LOG_ERRORF(...) WS_LOGF_AT(::cross_platform_websocket::LogLevel::ERROR, 3, __VA_ARGS__)
 
 } // namespace cross_platform_websocket 
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "mapped_file_sink.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace cross_platform_websocket {
+
+// 累计写入超过该字节数才提交一次回写，避免每批日志都进入内核
+static const size_t kFlushThreshold = 1024 * 1024;
+
+MappedFileLogSink::MappedFileLogSink()
+    : position_(0)
+    , flushed_(0)
+    , sequence_(0) {
+}
+
+MappedFileLogSink::~MappedFileLogSink() {
+    close();
+}
+
+bool MappedFileLogSink::open(const MappedFileLogSinkOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeSegment();
+    
+    options_ = options;
+    if (options_.prefix.empty()) {
+        options_.prefix = "websocket";
+    }
+    if (options_.segment_size < 4096) {
+        options_.segment_size = 4096;
+    }
+    if (!options_.directory.empty() && !MappedFile::createDirectory(options_.directory)) {
+        return false;
+    }
+    return rotate();
+}
+
+void MappedFileLogSink::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeSegment();
+}
+
+bool MappedFileLogSink::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.isOpen();
+}
+
+std::string MappedFileLogSink::currentPath() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.isOpen() ? file_.path() : std::string();
+}
+
+void MappedFileLogSink::write(LogLevel, const char* text, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.isOpen()) {
+        return;
+    }
+    
+    // 单行超过段大小时截断，保证一行不跨段
+    if (length + 1 > file_.size()) {
+        length = file_.size() - 1;
+    }
+    if (position_ + length + 1 > file_.size() && !rotate()) {
+        return;
+    }
+    
+    char* out = file_.data() + position_;
+    std::memcpy(out, text, length);
+    out[length] = '\n';
+    position_ += length + 1;
+}
+
+void MappedFileLogSink::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.isOpen() && position_ - flushed_ >= kFlushThreshold) {
+        file_.flush(flushed_, position_ - flushed_, false);
+        flushed_ = position_;
+    }
+}
+
+bool MappedFileLogSink::rotate() {
+    closeSegment();
+    
+    std::string path = nextPath();
+    if (!file_.open(path, options_.segment_size)) {
+        return false;
+    }
+    position_ = 0;
+    flushed_ = 0;
+    
+    segments_.push_back(path);
+    while (options_.max_segments > 0 && segments_.size() > options_.max_segments) {
+        std::remove(segments_.front().c_str());
+        segments_.pop_front();
+    }
+    return true;
+}
+
+void MappedFileLogSink::closeSegment() {
+    if (!file_.isOpen()) {
+        return;
+    }
+    
+    std::string path = file_.path();
+    size_t used = position_;
+    file_.close();
+    MappedFile::truncate(path, used);
+    position_ = 0;
+    flushed_ = 0;
+}
+
+std::string MappedFileLogSink::nextPath() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm;
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+    
+    std::string base = options_.directory.empty() ? std::string() : options_.directory + "/";
+    base += options_.prefix + "_" + stamp + "_";
+    
+    // 同一秒内多次切换或已有同名文件（例如另一进程）时递增序号
+    while (true) {
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "%04u.log", static_cast<unsigned>(sequence_++));
+        std::string path = base + suffix;
+        if (!MappedFile::exists(path)) {
+            return path;
+        }
+    }
+}
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "log_sink.h"
+#include "../storage/mapped_file.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 内存映射日志文件配置
+ */
+struct MappedFileLogSinkOptions {
+    std::string directory;  // 日志目录
+    std::string prefix;     // 文件名前缀
+    size_t segment_size;    // 单个段文件大小（字节），写满后切换到新段
+    size_t max_segments;    // 本进程最多保留的段文件数（0 表示不删除）
+    
+    MappedFileLogSinkOptions()
+        : prefix("websocket")
+        , segment_size(16 * 1024 * 1024)
+        , max_segments(8) {}
+};
+
+/**
+ * @brief 写入内存映射段文件的日志输出
+ * 
+ * 段文件在打开时预分配并整体映射，写日志只是一次 memcpy，不调用 write()；
+ * 数据写入映射区即进入页缓存，进程崩溃后最后一个段仍可直接读取
+ * （未写到的尾部为 \0，正常关闭时截断到实际长度）。
+ * 段写满时切换到新文件，超过 max_segments 时删除本进程写出的最旧的段；
+ * 文件名带创建时间和序号（prefix_YYYYmmdd_HHMMSS_NNNN.log），不会覆盖此前运行留下的文件。
+ */
+class MappedFileLogSink : public LogSink {
+public:
+    MappedFileLogSink();
+    ~MappedFileLogSink() override;
+    
+    /**
+     * @brief 打开第一个段文件
+     * @param options 配置
+     * @return 是否成功
+     */
+    bool open(const MappedFileLogSinkOptions& options);
+    
+    /**
+     * @brief 关闭当前段并截断到实际长度
+     */
+    void close();
+    
+    /**
+     * @brief 检查是否已打开
+     * @return 是否打开
+     */
+    bool isOpen() const;
+    
+    /**
+     * @brief 获取当前段文件路径
+     * @return 路径（未打开时为空）
+     */
+    std::string currentPath() const;
+    
+    void write(LogLevel level, const char* text, size_t length) override;
+    
+    /**
+     * @brief 已写入的数据累计超过阈值时异步通知内核回写（不等待完成）
+     * 
+     * 进程崩溃时页缓存中的数据不会丢失，回写只影响掉电时的损失量。
+     */
+    void flush() override;
+
+private:
+    MappedFileLogSink(const MappedFileLogSink&) = delete;
+    MappedFileLogSink& operator=(const MappedFileLogSink&) = delete;
+    
+    /**
+     * @brief 关闭当前段并打开新段（调用方持有 mutex_）
+     * @return 是否成功
+     */
+    bool rotate();
+    
+    /**
+     * @brief 关闭并截断当前段（调用方持有 mutex_）
+     */
+    void closeSegment();
+    
+    /**
+     * @brief 生成新段文件路径
+     * @return 路径
+     */
+    std::string nextPath();
+    
+    mutable std::mutex mutex_;
+    MappedFileLogSinkOptions options_;
+    MappedFile file_;
+    size_t position_;        // 当前段已写入的字节数
+    size_t flushed_;         // 已提交回写的字节数
+    uint32_t sequence_;      // 本进程内的段序号
+    std::deque<std::string> segments_;  // 本进程写出的段，最旧的在前
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,229 @@
+#include "buffer_pool.h"
+#include <cstdlib>
+#include <new>
+
+namespace cross_platform_websocket {
+
+const size_t BufferPool::kMinBlockSize;
+const size_t BufferPool::kMaxBlockSize;
+const size_t BufferPool::kSizeClasses;
+
+// 每个线程每个级别本地缓存的字节上限
+static const size_t kThreadCacheBytes = 256 * 1024;
+
+// 每个级别本地缓存的块数上限
+static const size_t kThreadCacheMaxBlocks = 64;
+
+// 每个级别共享空闲列表的字节上限
+static const size_t kSharedListBytes = 4 * 1024 * 1024;
+
+// 本线程的本地缓存是否已析构（线程退出或静态析构期间仍可能释放缓冲区）
+static thread_local bool t_thread_cache_destroyed = false;
+
+/**
+ * @brief 线程本地缓存，线程退出时把缓存的块归还共享空闲列表
+ */
+struct BufferPoolThreadCache {
+    std::vector<char*> blocks[BufferPool::kSizeClasses];
+    
+    ~BufferPoolThreadCache() {
+        BufferPool& pool = BufferPool::instance();
+        for (size_t i = 0; i < BufferPool::kSizeClasses; ++i) {
+            pool.flush(i, blocks[i], blocks[i].size());
+        }
+        t_thread_cache_destroyed = true;
+    }
+};
+
+static BufferPoolThreadCache* threadCache() {
+    if (t_thread_cache_destroyed) {
+        return nullptr;
+    }
+    static thread_local BufferPoolThreadCache cache;
+    return &cache;
+}
+
+BufferPool& BufferPool::instance() {
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+BufferPool::BufferPool() {
+}
+
+size_t BufferPool::blockSize(size_t size) {
+    if (size > kMaxBlockSize) {
+        return size;
+    }
+    size_t capacity = kMinBlockSize;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+size_t BufferPool::classIndex(size_t capacity) {
+    size_t index = 0;
+    for (size_t block = kMinBlockSize; block < capacity; block <<= 1) {
+        index++;
+    }
+    return index;
+}
+
+size_t BufferPool::threadCacheLimit(size_t class_index) {
+    size_t blocks = kThreadCacheBytes / (kMinBlockSize << class_index);
+    return blocks < kThreadCacheMaxBlocks ? (blocks > 2 ? blocks : 2) : kThreadCacheMaxBlocks;
+}
+
+size_t BufferPool::sharedLimit(size_t class_index) {
+    return kSharedListBytes / (kMinBlockSize << class_index);
+}
+
+char* BufferPool::allocate(size_t size, size_t& capacity) {
+    if (size == 0) {
+        capacity = 0;
+        return nullptr;
+    }
+    
+    stats_.add(STAT_ALLOCATIONS);
+    capacity = blockSize(size);
+    stats_.add(STAT_BYTES_IN_USE, capacity);
+    
+    if (capacity > kMaxBlockSize) {
+        stats_.add(STAT_OVERSIZE_ALLOCATIONS);
+        stats_.add(STAT_SYSTEM_ALLOCATIONS);
+        char* block = static_cast<char*>(std::malloc(capacity));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
+    
+    size_t index = classIndex(capacity);
+    BufferPoolThreadCache* thread_cache = threadCache();
+    if (!thread_cache) {
+        stats_.add(STAT_SYSTEM_ALLOCATIONS);
+        char* block = static_cast<char*>(std::malloc(capacity));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
+    
+    std::vector<char*>& cache = thread_cache->blocks[index];
+    if (!cache.empty()) {
+        stats_.add(STAT_THREAD_CACHE_HITS);
+    } else {
+        refill(index, cache, threadCacheLimit(index) / 2 + 1);
+    }
+    
+    char* block = cache.back();
+    cache.pop_back();
+    return block;
+}
+
+void BufferPool::release(char* block, size_t capacity) {
+    if (!block) {
+        return;
+    }
+    
+    stats_.add(STAT_RELEASES);
+    stats_.sub(STAT_BYTES_IN_USE, capacity);
+    
+    if (capacity > kMaxBlockSize) {
+        stats_.add(STAT_SYSTEM_FREES);
+        std::free(block);
+        return;
+    }
+    
+    size_t index = classIndex(capacity);
+    BufferPoolThreadCache* thread_cache = threadCache();
+    if (!thread_cache) {
+        stats_.add(STAT_SYSTEM_FREES);
+        std::free(block);
+        return;
+    }
+    
+    std::vector<char*>& cache = thread_cache->blocks[index];
+    if (cache.capacity() == 0) {
+        cache.reserve(threadCacheLimit(index));
+    }
+    cache.push_back(block);
+    
+    // 本地缓存满时归还一半，避免在阈值附近反复批量搬运
+    size_t limit = threadCacheLimit(index);
+    if (cache.size() >= limit) {
+        flush(index, cache, limit / 2);
+    }
+}
+
+BufferPoolStats BufferPool::getStats() const {
+    BufferPoolStats stats;
+    stats.allocations = stats_.get(STAT_ALLOCATIONS);
+    stats.releases = stats_.get(STAT_RELEASES);
+    stats.thread_cache_hits = stats_.get(STAT_THREAD_CACHE_HITS);
+    stats.shared_hits = stats_.get(STAT_SHARED_HITS);
+    stats.system_allocations = stats_.get(STAT_SYSTEM_ALLOCATIONS);
+    stats.system_frees = stats_.get(STAT_SYSTEM_FREES);
+    stats.oversize_allocations = stats_.get(STAT_OVERSIZE_ALLOCATIONS);
+    stats.bytes_in_use = stats_.getSigned(STAT_BYTES_IN_USE);
+    stats.bytes_cached = stats_.getSigned(STAT_BYTES_CACHED);
+    return stats;
+}
+
+void BufferPool::refill(size_t class_index, std::vector<char*>& cache, size_t count) {
+    size_t block_size = kMinBlockSize << class_index;
+    if (cache.capacity() == 0) {
+        cache.reserve(threadCacheLimit(class_index));
+    }
+    
+    {
+        SharedList& shared = shared_[class_index];
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        size_t taken = 0;
+        while (taken < count && !shared.blocks.empty()) {
+            cache.push_back(shared.blocks.back());
+            shared.blocks.pop_back();
+            taken++;
+        }
+        if (taken > 0) {
+            stats_.add(STAT_SHARED_HITS);
+            stats_.sub(STAT_BYTES_CACHED, taken * block_size);
+            return;
+        }
+    }
+    
+    char* block = static_cast<char*>(std::malloc(block_size));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    stats_.add(STAT_SYSTEM_ALLOCATIONS);
+    cache.push_back(block);
+}
+
+void BufferPool::flush(size_t class_index, std::vector<char*>& cache, size_t count) {
+    size_t block_size = kMinBlockSize << class_index;
+    SharedList& shared = shared_[class_index];
+    size_t limit = sharedLimit(class_index);
+    size_t cached = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        while (count > 0 && !cache.empty() && shared.blocks.size() < limit) {
+            shared.blocks.push_back(cache.back());
+            cache.pop_back();
+            cached++;
+            count--;
+        }
+    }
+    stats_.add(STAT_BYTES_CACHED, cached * block_size);
+    
+    while (count > 0 && !cache.empty()) {
+        std::free(cache.back());
+        cache.pop_back();
+        stats_.add(STAT_SYSTEM_FREES);
+        count--;
+    }
+}
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "../metrics/sharded_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 缓冲区池统计信息
+ */
+struct BufferPoolStats {
+    uint64_t allocations;          // 分配次数
+    uint64_t releases;             // 释放次数
+    uint64_t thread_cache_hits;    // 线程本地缓存命中次数
+    uint64_t shared_hits;          // 共享空闲列表命中次数
+    uint64_t system_allocations;   // 向系统申请内存的次数（含超大块）
+    uint64_t system_frees;         // 归还系统的次数
+    uint64_t oversize_allocations; // 超过最大尺寸级别、直接向系统申请的次数
+    uint64_t bytes_in_use;         // 使用中的字节数（按尺寸级别计）
+    uint64_t bytes_cached;         // 共享空闲列表中缓存的字节数
+};
+
+/**
+ * @brief 按尺寸级别分配消息缓冲区的内存池
+ * 
+ * 尺寸级别为 64 字节到 64KB 的 2 的幂，共 11 级，超过 64KB 的请求直接向系统申请。
+ * 每个线程持有各级别的本地缓存，分配和释放先走本地缓存，不加锁；本地缓存
+ * 空了从共享空闲列表批量补充，满了批量归还，共享列表按级别各自加锁。
+ * 稳态收发时缓冲区在池中循环使用，不再调用 malloc/free。
+ * 
+ * 池为进程级单例，且有意不析构，保证线程退出和静态析构期间归还缓冲区安全。
+ */
+class BufferPool {
+public:
+    /**
+     * @brief 最小尺寸级别（字节）
+     */
+    static const size_t kMinBlockSize = 64;
+    
+    /**
+     * @brief 最大尺寸级别（字节）
+     */
+    static const size_t kMaxBlockSize = 64 * 1024;
+    
+    /**
+     * @brief 尺寸级别数
+     */
+    static const size_t kSizeClasses = 11;
+    
+    /**
+     * @brief 获取进程级缓冲区池
+     * @return 缓冲区池
+     */
+    static BufferPool& instance();
+    
+    /**
+     * @brief 分配缓冲区
+     * @param size 所需字节数
+     * @param capacity 实际容量（释放时原样传回）
+     * @return 缓冲区指针，size 为 0 时返回 nullptr
+     */
+    char* allocate(size_t size, size_t& capacity);
+    
+    /**
+     * @brief 释放缓冲区
+     * @param block 缓冲区指针（可为 nullptr）
+     * @param capacity 分配时返回的容量
+     */
+    void release(char* block, size_t capacity);
+    
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    BufferPoolStats getStats() const;
+    
+    /**
+     * @brief 计算请求大小对应的分配容量
+     * @param size 所需字节数
+     * @return 容量（尺寸级别，超大块原样返回）
+     */
+    static size_t blockSize(size_t size);
+
+private:
+    BufferPool();
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    
+    friend struct BufferPoolThreadCache;
+    
+    /**
+     * @brief 单个尺寸级别的共享空闲列表
+     */
+    struct SharedList {
+        std::mutex mutex;
+        std::vector<char*> blocks;
+    };
+    
+    static size_t classIndex(size_t capacity);
+    static size_t threadCacheLimit(size_t class_index);
+    static size_t sharedLimit(size_t class_index);
+    
+    /**
+     * @brief 从共享空闲列表批量取出，不足时向系统申请
+     */
+    void refill(size_t class_index, std::vector<char*>& cache, size_t count);
+    
+    /**
+     * @brief 批量归还共享空闲列表，超出上限的部分归还系统
+     */
+    void flush(size_t class_index, std::vector<char*>& cache, size_t count);
+    
+    SharedList shared_[kSizeClasses];
+    
+    // 统计计数在每次分配和释放时由所有线程更新，按线程分片计数
+    enum StatCounter {
+        STAT_ALLOCATIONS,
+        STAT_RELEASES,
+        STAT_THREAD_CACHE_HITS,
+        STAT_SHARED_HITS,
+        STAT_SYSTEM_ALLOCATIONS,
+        STAT_SYSTEM_FREES,
+        STAT_OVERSIZE_ALLOCATIONS,
+        STAT_BYTES_IN_USE,      // 可增可减
+        STAT_BYTES_CACHED,      // 可增可减
+        STAT_COUNT
+    };
+    ShardedCounters<STAT_COUNT> stats_;
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,211 @@
+#include "payload.h"
+#include <cstring>
+#include <utility>
+
+namespace cross_platform_websocket {
+
+Payload::Payload()
+    : data_(inline_)
+    , size_(0)
+    , capacity_(kInlineCapacity) {
+}
+
+Payload::Payload(const char* data, size_t size)
+    : data_(inline_)
+    , size_(0)
+    , capacity_(kInlineCapacity) {
+    assign(data, size);
+}
+
+Payload::Payload(const std::string& data)
+    : data_(inline_)
+    , size_(0)
+    , capacity_(kInlineCapacity) {
+    assign(data.data(), data.size());
+}
+
+Payload::Payload(const SharedPayload& shared)
+    : data_(inline_)
+    , size_(0)
+    , capacity_(kInlineCapacity) {
+    share(shared);
+}
+
+Payload::Payload(const Payload& other)
+    : data_(inline_)
+    , size_(0)
+    , capacity_(kInlineCapacity) {
+    if (other.isShared()) {
+        share(other.shared_);
+    } else {
+        assign(other.data_, other.size_);
+    }
+}
+
+Payload::Payload(Payload&& other) noexcept
+    : data_(inline_)
+    , size_(0)
+    , capacity_(kInlineCapacity) {
+    take(other);
+}
+
+Payload::~Payload() {
+    freeBuffer();
+}
+
+Payload& Payload::operator=(const Payload& other) {
+    if (this != &other) {
+        if (other.isShared()) {
+            release();
+            share(other.shared_);
+        } else {
+            assign(other.data_, other.size_);
+        }
+    }
+    return *this;
+}
+
+Payload& Payload::operator=(Payload&& other) noexcept {
+    if (this != &other) {
+        release();
+        take(other);
+    }
+    return *this;
+}
+
+Payload& Payload::operator=(const std::string& data) {
+    assign(data.data(), data.size());
+    return *this;
+}
+
+void Payload::reserve(size_t capacity) {
+    detach();
+    if (capacity <= capacity_) {
+        return;
+    }
+    
+    size_t new_capacity = 0;
+    char* block = BufferPool::instance().allocate(capacity, new_capacity);
+    if (size_ > 0) {
+        std::memcpy(block, data_, size_);
+    }
+    freeBuffer();
+    data_ = block;
+    capacity_ = new_capacity;
+}
+
+void Payload::assign(const char* data, size_t size) {
+    if (isShared()) {
+        // 整体替换时不必复制旧的共享内容，但源可能位于共享缓冲区内，复制完成前保持引用
+        SharedPayload owner = std::move(shared_);
+        resetInline();
+        append(data, size);
+        return;
+    }
+    size_ = 0;
+    append(data, size);
+}
+
+void Payload::append(const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    if (isShared()) {
+        // 源可能位于共享缓冲区内，复制出私有缓冲区并追加完成前保持引用
+        SharedPayload owner = shared_;
+        detach();
+        append(data, size);
+        return;
+    }
+    
+    if (size_ + size > capacity_) {
+        // 按倍数增长，避免逐段追加时反复换块；源可能位于旧缓冲区内，复制完成后再释放旧块
+        size_t wanted = size_ + size;
+        size_t new_capacity = 0;
+        char* block = BufferPool::instance().allocate(
+            size_ > 0 && wanted < capacity_ * 2 ? capacity_ * 2 : wanted, new_capacity);
+        if (size_ > 0) {
+            std::memcpy(block, data_, size_);
+        }
+        std::memcpy(block + size_, data, size);
+        freeBuffer();
+        data_ = block;
+        capacity_ = new_capacity;
+    } else {
+        // 源可能与目标重叠（自追加或原地 assign）
+        std::memmove(data_ + size_, data, size);
+    }
+    size_ += size;
+}
+
+void Payload::clear() {
+    if (isShared()) {
+        resetInline();
+    }
+    size_ = 0;
+}
+
+void Payload::release() {
+    freeBuffer();
+    resetInline();
+}
+
+bool Payload::equals(const std::string& other) const {
+    return size_ == other.size() && (size_ == 0 || std::memcmp(data_, other.data(), size_) == 0);
+}
+
+void Payload::detach() {
+    if (!isShared()) {
+        return;
+    }
+    
+    // 复制出私有缓冲区后再放弃共享引用
+    SharedPayload shared = std::move(shared_);
+    resetInline();
+    if (shared.size() > capacity_) {
+        data_ = BufferPool::instance().allocate(shared.size(), capacity_);
+    }
+    std::memcpy(data_, shared.data(), shared.size());
+    size_ = shared.size();
+}
+
+void Payload::share(const SharedPayload& shared) {
+    if (shared.empty()) {
+        return;
+    }
+    shared_ = shared;
+    data_ = const_cast<char*>(shared_.data());
+    size_ = shared_.size();
+    capacity_ = 0;
+}
+
+void Payload::take(Payload& other) {
+    if (other.isShared()) {
+        shared_ = std::move(other.shared_);
+        data_ = other.data_;
+        capacity_ = 0;
+    } else if (other.isInline()) {
+        // 内联数据随对象复制，内存池缓冲区直接转移
+        std::memcpy(inline_, other.inline_, other.size_);
+    } else {
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+    }
+    size_ = other.size_;
+    other.resetInline();
+}
+
+void Payload::freeBuffer() {
+    if (!isShared() && !isInline()) {
+        BufferPool::instance().release(data_, capacity_);
+    }
+}
+
+void Payload::resetInline() {
+    shared_.reset();
+    data_ = inline_;
+    size_ = 0;
+    capacity_ = kInlineCapacity;
+}
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "buffer_pool.h"
+#include "shared_payload.h"
+#include <cstddef>
+#include <string>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 消息负载缓冲区
+ * 
+ * 不超过 kInlineCapacity 字节的负载直接存放在对象内（队列槽位或事件对象中），
+ * 不分配内存；更大的负载使用 BufferPool 按尺寸级别复用的缓冲区。
+ * 接口为 std::string 的常用子集。复制时深拷贝，移动时转移缓冲区（内联数据随对象复制）；
+ * clear 保留容量，析构时归还内存池。
+ * 由 SharedPayload 构造时只引用共享数据（复制也只增加引用计数），
+ * 首次修改时才复制出私有缓冲区。
+ */
+class Payload {
+public:
+    static const size_t kInlineCapacity = 128;
+    
+    Payload();
+    Payload(const char* data, size_t size);
+    Payload(const std::string& data);
+    Payload(const SharedPayload& shared);
+    Payload(const Payload& other);
+    Payload(Payload&& other) noexcept;
+    ~Payload();
+    
+    Payload& operator=(const Payload& other);
+    Payload& operator=(Payload&& other) noexcept;
+    Payload& operator=(const std::string& data);
+    
+    /**
+     * @brief 获取数据指针
+     * @return 数据指针（移动后地址可能改变）
+     */
+    const char* data() const { return data_; }
+    
+    /**
+     * @brief 获取数据长度
+     * @return 字节数
+     */
+    size_t size() const { return size_; }
+    
+    /**
+     * @brief 获取容量
+     * @return 字节数
+     */
+    size_t capacity() const { return capacity_; }
+    
+    /**
+     * @brief 检查是否引用共享负载
+     * @return 是否共享
+     */
+    bool isShared() const { return !shared_.empty(); }
+    
+    /**
+     * @brief 检查数据是否存放在对象内
+     * @return 是否内联
+     */
+    bool isInline() const { return data_ == inline_; }
+    
+    /**
+     * @brief 检查是否为空
+     * @return 是否为空
+     */
+    bool empty() const { return size_ == 0; }
+    
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+    
+    /**
+     * @brief 预留容量（保留已有数据）
+     * @param capacity 所需容量
+     */
+    void reserve(size_t capacity);
+    
+    /**
+     * @brief 替换内容
+     * @param data 数据指针
+     * @param size 字节数
+     */
+    void assign(const char* data, size_t size);
+    
+    /**
+     * @brief 追加内容
+     * @param data 数据指针
+     * @param size 字节数
+     */
+    void append(const char* data, size_t size);
+    
+    /**
+     * @brief 追加字符串
+     * @param data 字符串
+     */
+    void append(const std::string& data) { append(data.data(), data.size()); }
+    
+    /**
+     * @brief 追加一个字节
+     * @param c 字节
+     */
+    void push_back(char c) { append(&c, 1); }
+    
+    /**
+     * @brief 清空内容（保留容量）
+     */
+    void clear();
+    
+    /**
+     * @brief 清空内容并把缓冲区归还内存池（恢复为内联存储）
+     */
+    void release();
+    
+    /**
+     * @brief 复制为 std::string
+     * @return 字符串
+     */
+    std::string str() const { return std::string(data_, size_); }
+    
+    /**
+     * @brief 比较内容
+     * @param other 字符串
+     * @return 内容是否相同
+     */
+    bool equals(const std::string& other) const;
+
+private:
+    char* data_;            // 指向 inline_、内存池缓冲区或共享负载
+    size_t size_;
+    size_t capacity_;       // 共享模式下为 0
+    SharedPayload shared_;  // 共享模式下持有的引用
+    char inline_[kInlineCapacity];
+    
+    void detach();
+    void share(const SharedPayload& shared);
+    void take(Payload& other);
+    void freeBuffer();
+    void resetInline();
+};
+
+} // namespace cross_platform_websocket
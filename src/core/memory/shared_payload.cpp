@@ -0,0 +1,93 @@
+#include "shared_payload.h"
+#include "buffer_pool.h"
+#include <cstring>
+#include <new>
+
+namespace cross_platform_websocket {
+
+SharedPayload::SharedPayload()
+    : block_(nullptr) {
+}
+
+SharedPayload::SharedPayload(const char* data, size_t size)
+    : block_(nullptr) {
+    if (size == 0) {
+        return;
+    }
+    
+    size_t capacity = 0;
+    char* memory = BufferPool::instance().allocate(sizeof(Block) + size, capacity);
+    block_ = new (memory) Block();
+    block_->refs.store(1, std::memory_order_relaxed);
+    block_->size = size;
+    block_->capacity = capacity;
+    std::memcpy(block_->payload(), data, size);
+}
+
+SharedPayload::SharedPayload(const std::string& data)
+    : SharedPayload(data.data(), data.size()) {
+}
+
+SharedPayload::SharedPayload(const SharedPayload& other)
+    : block_(other.block_) {
+    if (block_) {
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SharedPayload::SharedPayload(SharedPayload&& other) noexcept
+    : block_(other.block_) {
+    other.block_ = nullptr;
+}
+
+SharedPayload::~SharedPayload() {
+    reset();
+}
+
+SharedPayload& SharedPayload::operator=(const SharedPayload& other) {
+    if (block_ != other.block_) {
+        if (other.block_) {
+            other.block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        reset();
+        block_ = other.block_;
+    }
+    return *this;
+}
+
+SharedPayload& SharedPayload::operator=(SharedPayload&& other) noexcept {
+    if (this != &other) {
+        reset();
+        block_ = other.block_;
+        other.block_ = nullptr;
+    }
+    return *this;
+}
+
+const char* SharedPayload::data() const {
+    return block_ ? block_->payload() : nullptr;
+}
+
+size_t SharedPayload::size() const {
+    return block_ ? block_->size : 0;
+}
+
+uint32_t SharedPayload::useCount() const {
+    return block_ ? block_->refs.load(std::memory_order_relaxed) : 0;
+}
+
+void SharedPayload::reset() {
+    if (!block_) {
+        return;
+    }
+    
+    // 最后一个引用负责释放，acq_rel 保证其他线程对负载的读取先于释放完成
+    if (block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        size_t capacity = block_->capacity;
+        block_->~Block();
+        BufferPool::instance().release(reinterpret_cast<char*>(block_), capacity);
+    }
+    block_ = nullptr;
+}
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 引用计数的不可变消息负载
+ * 
+ * 负载内容只存储一份（控制块和数据在 BufferPool 的同一块内存中），复制只增加
+ * 原子引用计数。同一负载可提交给任意多个连接，各连接只做自己的帧头和掩码，
+ * 最后一个引用释放时内存归还内存池。
+ */
+class SharedPayload {
+public:
+    /**
+     * @brief 构造空负载
+     */
+    SharedPayload();
+    
+    /**
+     * @brief 复制数据构造负载（唯一一次复制）
+     * @param data 数据指针
+     * @param size 字节数
+     */
+    SharedPayload(const char* data, size_t size);
+    
+    /**
+     * @brief 复制字符串构造负载
+     * @param data 字符串
+     */
+    explicit SharedPayload(const std::string& data);
+    
+    SharedPayload(const SharedPayload& other);
+    SharedPayload(SharedPayload&& other) noexcept;
+    ~SharedPayload();
+    
+    SharedPayload& operator=(const SharedPayload& other);
+    SharedPayload& operator=(SharedPayload&& other) noexcept;
+    
+    /**
+     * @brief 获取数据指针
+     * @return 数据指针（空负载时为 nullptr）
+     */
+    const char* data() const;
+    
+    /**
+     * @brief 获取数据长度
+     * @return 字节数
+     */
+    size_t size() const;
+    
+    /**
+     * @brief 检查是否为空
+     * @return 是否为空
+     */
+    bool empty() const { return size() == 0; }
+    
+    /**
+     * @brief 获取当前引用数
+     * @return 引用数（空负载为 0）
+     */
+    uint32_t useCount() const;
+    
+    /**
+     * @brief 复制为 std::string
+     * @return 字符串
+     */
+    std::string str() const { return std::string(data() ? data() : "", size()); }
+    
+    /**
+     * @brief 释放引用，变为空负载
+     */
+    void reset();
+
+private:
+    /**
+     * @brief 控制块，数据紧跟其后
+     */
+    struct Block {
+        std::atomic<uint32_t> refs;
+        size_t size;
+        size_t capacity;   // 整块容量，归还内存池时使用
+        
+        char* payload() { return reinterpret_cast<char*>(this + 1); }
+    };
+    
+    Block* block_;
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,182 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cross_platform_websocket {
+
+const unsigned LatencyHistogram::kSubBucketBits;
+const unsigned LatencyHistogram::kMaxValueBits;
+const size_t LatencyHistogram::kSubBucketHalf;
+const size_t LatencyHistogram::kBucketCount;
+const unsigned LatencyHistogram::kShortValueBits;
+
+LatencySnapshot::LatencySnapshot()
+    : total_(0)
+    , min_(std::numeric_limits<uint64_t>::max())
+    , max_(0) {
+}
+
+void LatencySnapshot::merge(const LatencySnapshot& other) {
+    // 副本只复制到最后一个非空桶，长度可能不同
+    if (counts_.size() < other.counts_.size()) {
+        counts_.resize(other.counts_.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+uint64_t LatencySnapshot::percentile(double percentile) const {
+    if (total_ == 0) {
+        return 0;
+    }
+    
+    // 排名向上取整：p99 是至少覆盖 99% 样本的最小值
+    double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total_)));
+    rank = std::max<uint64_t>(rank, 1);
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return std::max(std::min(LatencyHistogram::bucketUpperBound(i), max_), min_);
+        }
+    }
+    return max_;
+}
+
+LatencyStats LatencySnapshot::stats() const {
+    LatencyStats result;
+    if (total_ == 0) {
+        return result;
+    }
+    
+    double sum = 0.0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        if (counts_[i] > 0) {
+            double middle = (static_cast<double>(LatencyHistogram::bucketLowerBound(i)) +
+                             static_cast<double>(LatencyHistogram::bucketUpperBound(i))) / 2.0;
+            sum += middle * static_cast<double>(counts_[i]);
+        }
+    }
+    
+    result.count = total_;
+    result.min_ns = min_;
+    result.max_ns = max_;
+    result.mean_ns = static_cast<uint64_t>(sum / static_cast<double>(total_));
+    result.mean_ns = std::max(std::min(result.mean_ns, max_), min_);
+    result.p50_ns = percentile(50.0);
+    result.p90_ns = percentile(90.0);
+    result.p99_ns = percentile(99.0);
+    result.p999_ns = percentile(99.9);
+    return result;
+}
+
+LatencyHistogram::LatencyHistogram(unsigned max_value_bits)
+    : counts_(nullptr)
+    , enabled_(true)
+    , min_(std::numeric_limits<uint64_t>::max())
+    , max_(0) {
+    unsigned bits = std::min(std::max(max_value_bits, kSubBucketBits + 1), kMaxValueBits);
+    bucket_count_ = (bits - kSubBucketBits + 2) * kSubBucketHalf;
+    max_value_ = (uint64_t(1) << bits) - 1;
+}
+
+LatencyHistogram::~LatencyHistogram() {
+    delete[] counts_.load(std::memory_order_acquire);
+}
+
+std::atomic<uint64_t>* LatencyHistogram::allocateCounts() {
+    std::atomic<uint64_t>* counts = new std::atomic<uint64_t>[bucket_count_];
+    for (size_t i = 0; i < bucket_count_; ++i) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    
+    // 多个线程同时首次记录时只保留一份
+    std::atomic<uint64_t>* expected = nullptr;
+    if (!counts_.compare_exchange_strong(expected, counts, std::memory_order_acq_rel)) {
+        delete[] counts;
+        return expected;
+    }
+    return counts;
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const {
+    LatencySnapshot result;
+    std::atomic<uint64_t>* counts = counts_.load(std::memory_order_acquire);
+    if (!counts) {
+        return result;
+    }
+    
+    // 只复制到最后一个非空桶，低延迟指标的副本远小于整个桶数组
+    size_t last = bucket_count_;
+    while (last > 0 && counts[last - 1].load(std::memory_order_relaxed) == 0) {
+        --last;
+    }
+    if (last == 0) {
+        return result;
+    }
+    
+    result.counts_.resize(last, 0);
+    for (size_t i = 0; i < last; ++i) {
+        uint64_t count = counts[i].load(std::memory_order_relaxed);
+        result.counts_[i] = count;
+        result.total_ += count;
+    }
+    if (result.total_ == 0) {
+        result.counts_.clear();
+        return result;
+    }
+    
+    result.min_ = min_.load(std::memory_order_relaxed);
+    result.max_ = max_.load(std::memory_order_relaxed);
+    
+    // 并发记录时桶计数可能先于最值可见，此时退回到桶边界
+    size_t first = 0;
+    while (result.counts_[first] == 0) {
+        ++first;
+    }
+    last = result.counts_.size() - 1;
+    while (result.counts_[last] == 0) {
+        --last;
+    }
+    result.min_ = std::min(result.min_, bucketUpperBound(first));
+    result.max_ = std::max(result.max_, bucketLowerBound(last));
+    return result;
+}
+
+void LatencyHistogram::reset() {
+    std::atomic<uint64_t>* counts = counts_.load(std::memory_order_acquire);
+    if (counts) {
+        for (size_t i = 0; i < bucket_count_; ++i) {
+            counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / kSubBucketHalf) - 1;
+    uint64_t sub = index % kSubBucketHalf + kSubBucketHalf;
+    return sub << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / kSubBucketHalf) - 1;
+    uint64_t sub = index % kSubBucketHalf + kSubBucketHalf;
+    return ((sub + 1) << shift) - 1;
+}
+
+} // namespace cross_platform_websocket
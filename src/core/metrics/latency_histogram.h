@@ -0,0 +1,248 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 延迟指标
+ */
+enum class LatencyMetric {
+    CONNECT_ATTEMPT = 0,    // 单次传输层握手（websocketConnect）耗时，只记录成功的尝试
+    CONNECT_TOTAL = 1,      // 从发起连接到连接建立的总耗时（含重连等待和失败的尝试）
+    SEND = 2,               // 已连接时从接受消息到写入传输层的耗时（直接发送和公平调度）
+    QUEUE_WAIT = 3,         // 消息在离线/积压队列中等待到被写入传输层的耗时
+    PING_RTT = 4            // Ping 往返时间
+};
+
+/**
+ * @brief 延迟指标数量
+ */
+static const size_t kLatencyMetricCount = 5;
+
+/**
+ * @brief 延迟统计摘要（单位：纳秒）
+ */
+struct LatencyStats {
+    uint64_t count;     // 样本数
+    uint64_t min_ns;    // 最小值
+    uint64_t max_ns;    // 最大值
+    uint64_t mean_ns;   // 平均值（按桶中点估算）
+    uint64_t p50_ns;    // 50 分位
+    uint64_t p90_ns;    // 90 分位
+    uint64_t p99_ns;    // 99 分位
+    uint64_t p999_ns;   // 99.9 分位
+    
+    LatencyStats()
+        : count(0), min_ns(0), max_ns(0), mean_ns(0)
+        , p50_ns(0), p90_ns(0), p99_ns(0), p999_ns(0) {}
+};
+
+/**
+ * @brief 延迟直方图在某一时刻的副本，可跨连接合并后计算分位数
+ */
+class LatencySnapshot {
+public:
+    LatencySnapshot();
+    
+    /**
+     * @brief 合并另一份副本（例如另一个连接的同一指标）
+     * @param other 另一份副本
+     */
+    void merge(const LatencySnapshot& other);
+    
+    /**
+     * @brief 获取样本数
+     * @return 样本数
+     */
+    uint64_t count() const { return total_; }
+    
+    /**
+     * @brief 计算分位数
+     * @param percentile 百分位（0 到 100，例如 99.9）
+     * @return 该分位所在桶的上界（纳秒，不超过最大值），无样本时为 0
+     */
+    uint64_t percentile(double percentile) const;
+    
+    /**
+     * @brief 计算统计摘要
+     * @return 统计摘要
+     */
+    LatencyStats stats() const;
+
+private:
+    friend class LatencyHistogram;
+    
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+/**
+ * @brief 无锁对数线性延迟直方图（HDR 风格）
+ * 
+ * 小于 64ns 的值各占一个桶，更大的值按 2 的幂分段、每段 32 个线性子桶，
+ * 相对误差不超过 1/32；超过量程（2^max_value_bits ns）的值计入最后一个桶，最大值仍按实际记录。
+ * 量程为 2^40 ns（约 18 分钟）时共 1152 个桶、约 9KB，2^34 ns（约 17 秒）时 960 个桶、约 7.5KB；
+ * 不同量程的桶下标一致，副本可以直接合并。
+ * 
+ * 桶数组在第一次记录时才分配，从未记录过的直方图只占几十字节，禁用后不再分配。
+ * 记录一次只是一次前导零计数和一次 relaxed fetch_add，最小值和最大值只在被刷新时才做 CAS。
+ * 读取时复制到最后一个非空桶为止得到 LatencySnapshot，不阻塞记录方；
+ * 复制期间并发记录的样本可能只部分计入，不影响分位数的准确性。
+ */
+class LatencyHistogram {
+public:
+    static const unsigned kSubBucketBits = 6;
+    static const unsigned kMaxValueBits = 40;
+    static const size_t kSubBucketHalf = size_t(1) << (kSubBucketBits - 1);
+    static const size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 2) * kSubBucketHalf;
+    // 较短的量程（约 17 秒），用于发送、握手和 Ping 往返等正常情况下远低于秒级的指标
+    static const unsigned kShortValueBits = 34;
+    
+    /**
+     * @brief 构造函数
+     * @param max_value_bits 量程（2 的幂次，纳秒），取值范围 kSubBucketBits + 1 到 kMaxValueBits
+     */
+    explicit LatencyHistogram(unsigned max_value_bits = kMaxValueBits);
+    ~LatencyHistogram();
+    
+    /**
+     * @brief 记录一个样本
+     * @param value_ns 延迟（纳秒）
+     */
+    void record(uint64_t value_ns) {
+        if (!enabled_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::atomic<uint64_t>* counts = counts_.load(std::memory_order_acquire);
+        if (!counts) {
+            counts = allocateCounts();
+        }
+        counts[bucketIndex(value_ns < max_value_ ? value_ns : max_value_)].fetch_add(1, std::memory_order_relaxed);
+        
+        uint64_t current = max_.load(std::memory_order_relaxed);
+        while (value_ns > current &&
+               !max_.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {
+        }
+        current = min_.load(std::memory_order_relaxed);
+        while (value_ns < current &&
+               !min_.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+    
+    /**
+     * @brief 记录从指定时刻到现在的耗时
+     * @param start_ns nowNanos() 取得的起始时刻，0 表示未知（不记录）
+     */
+    void recordSince(uint64_t start_ns) {
+        if (start_ns != 0) {
+            uint64_t now = nowNanos();
+            record(now > start_ns ? now - start_ns : 0);
+        }
+    }
+    
+    /**
+     * @brief 复制当前数据
+     * @return 副本
+     */
+    LatencySnapshot snapshot() const;
+    
+    /**
+     * @brief 清空所有样本
+     */
+    void reset();
+    
+    /**
+     * @brief 启用或禁用记录（默认启用）
+     * 
+     * 禁用后不再记录，尚未分配的桶数组也不再分配；已分配的桶数组保留到对象销毁。
+     * 
+     * @param enabled 是否启用
+     */
+    void setEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief 桶数组分配后占用的字节数
+     * @return 字节数
+     */
+    size_t bucketBytes() const {
+        return bucket_count_ * sizeof(std::atomic<uint64_t>);
+    }
+    
+    /**
+     * @brief 获取单调时钟的当前时刻
+     * @return 纳秒
+     */
+    static uint64_t nowNanos() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    
+    /**
+     * @brief 计算值所在的桶
+     * @param value_ns 值（纳秒）
+     * @return 桶下标
+     */
+    static size_t bucketIndex(uint64_t value_ns) {
+        const uint64_t linear_limit = uint64_t(1) << kSubBucketBits;
+        if (value_ns < linear_limit) {
+            return static_cast<size_t>(value_ns);
+        }
+        if (value_ns >> kMaxValueBits) {
+            value_ns = (uint64_t(1) << kMaxValueBits) - 1;
+        }
+        unsigned shift = highestBit(value_ns) - kSubBucketBits + 1;
+        return shift * kSubBucketHalf + static_cast<size_t>(value_ns >> shift);
+    }
+    
+    /**
+     * @brief 计算桶内的最大值
+     * @param index 桶下标
+     * @return 上界（纳秒）
+     */
+    static uint64_t bucketUpperBound(size_t index);
+    
+    /**
+     * @brief 计算桶内的最小值
+     * @param index 桶下标
+     * @return 下界（纳秒）
+     */
+    static uint64_t bucketLowerBound(size_t index);
+
+private:
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    static unsigned highestBit(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+    
+    std::atomic<uint64_t>* allocateCounts();
+    
+    size_t bucket_count_;                           // 按量程计算的桶数
+    uint64_t max_value_;                            // 量程内的最大值，更大的值按它计入最后一个桶
+    std::atomic<std::atomic<uint64_t>*> counts_;    // 桶数组，第一次记录时分配
+    std::atomic<bool> enabled_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 按线程分片、按缓存行对齐的一组统计计数器
+ * 
+ * 同一组件的 N 个计数器放在同一分片内，每个分片独占整数个缓存行，共 kShardCount 个分片。
+ * 线程第一次计数时按轮转分配一个分片并记在线程本地变量中，之后只对自己的分片做
+ * relaxed fetch_add，不同线程同时计数时不会争用同一缓存行；读取时把所有分片相加。
+ * 线程数超过分片数时多个线程共用分片，结果仍然准确，只是会有争用。
+ * 
+ * 读取不是原子快照：两个计数器之间、以及同一计数器的加减之间，读到的可能是不同时刻的值。
+ * 可增可减的计数（如使用中的字节数）用 add/sub 维护，按补码求和后用 getSigned 读取。
+ * 
+ * 分片存放在单独分配并手工对齐的内存中，不依赖 C++17 的对齐 new。
+ * 
+ * @tparam N 计数器个数
+ */
+template <size_t N>
+class ShardedCounters {
+public:
+    static const size_t kShardCount = 8;
+    static const size_t kCacheLineSize = 64;
+    
+    ShardedCounters()
+        : storage_(new char[kShardStride * kShardCount + kCacheLineSize]) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage_.get());
+        address = (address + kCacheLineSize - 1) & ~static_cast<uintptr_t>(kCacheLineSize - 1);
+        base_ = reinterpret_cast<char*>(address);
+        for (size_t shard = 0; shard < kShardCount; ++shard) {
+            for (size_t counter = 0; counter < N; ++counter) {
+                new (slot(shard, counter)) std::atomic<uint64_t>(0);
+            }
+        }
+    }
+    
+    /**
+     * @brief 增加计数
+     * @param counter 计数器下标
+     * @param value 增量
+     */
+    void add(size_t counter, uint64_t value = 1) {
+        slot(threadShard(), counter)->fetch_add(value, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief 减少计数（用于可增可减的计数）
+     * @param counter 计数器下标
+     * @param value 减量
+     */
+    void sub(size_t counter, uint64_t value) {
+        slot(threadShard(), counter)->fetch_sub(value, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief 读取计数（所有分片之和）
+     * @param counter 计数器下标
+     * @return 计数
+     */
+    uint64_t get(size_t counter) const {
+        uint64_t total = 0;
+        for (size_t shard = 0; shard < kShardCount; ++shard) {
+            total += slot(shard, counter)->load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+    
+    /**
+     * @brief 读取可增可减的计数
+     * 
+     * 读取期间另一分片上的减少可能先于对应的增加被计入，此时按 0 返回。
+     * 
+     * @param counter 计数器下标
+     * @return 计数
+     */
+    uint64_t getSigned(size_t counter) const {
+        int64_t total = static_cast<int64_t>(get(counter));
+        return total > 0 ? static_cast<uint64_t>(total) : 0;
+    }
+    
+    /**
+     * @brief 清零所有计数器
+     */
+    void reset() {
+        for (size_t shard = 0; shard < kShardCount; ++shard) {
+            for (size_t counter = 0; counter < N; ++counter) {
+                slot(shard, counter)->store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    ShardedCounters(const ShardedCounters&) = delete;
+    ShardedCounters& operator=(const ShardedCounters&) = delete;
+    
+    // 每个分片占用的字节数，向上取整到缓存行
+    static const size_t kShardStride =
+        (N * sizeof(std::atomic<uint64_t>) + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+    
+    std::atomic<uint64_t>* slot(size_t shard, size_t counter) const {
+        return reinterpret_cast<std::atomic<uint64_t>*>(base_ + shard * kShardStride) + counter;
+    }
+    
+    /**
+     * @brief 当前线程使用的分片（首次调用时轮转分配）
+     * @return 分片下标
+     */
+    static size_t threadShard() {
+        static std::atomic<size_t> next_shard(0);
+        static thread_local size_t shard = kShardCount;
+        if (shard == kShardCount) {
+            shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+        }
+        return shard;
+    }
+    
+    std::unique_ptr<char[]> storage_;
+    char* base_;
+};
+
+template <size_t N>
+const size_t ShardedCounters<N>::kShardCount;
+
+template <size_t N>
+const size_t ShardedCounters<N>::kCacheLineSize;
+
+template <size_t N>
+const size_t ShardedCounters<N>::kShardStride;
+
+} // namespace cross_platform_websocket
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 无锁令牌桶
+ * 
+ * 采用 GCRA（虚拟调度）实现：桶状态只有一个"理论到达时间"原子变量，
+ * 每次取令牌是一次 steady_clock 读取加一次 CAS，不加锁、不进入内核
+ * （steady_clock 在主流平台上经 vDSO/QPC 读取）。
+ * 
+ * 速率为 0 表示不限速；单次请求的令牌数超过桶容量时，只在桶满时放行并透支。
+ */
+class TokenBucket {
+public:
+    TokenBucket()
+        : interval_ns_(0.0)
+        , capacity_ns_(0.0)
+        , tat_ns_(0) {}
+    
+    /**
+     * @brief 设置速率和突发容量
+     * @param rate_per_second 每秒补充的令牌数，0 表示不限速
+     * @param burst 桶容量（令牌数）
+     */
+    void configure(double rate_per_second, double burst) {
+        double interval = rate_per_second > 0.0 ? 1e9 / rate_per_second : 0.0;
+        capacity_ns_.store(interval * (burst > 1.0 ? burst : 1.0), std::memory_order_relaxed);
+        interval_ns_.store(interval, std::memory_order_relaxed);
+        tat_ns_.store(0, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief 检查是否限速
+     * @return 是否限速
+     */
+    bool isLimited() const {
+        return interval_ns_.load(std::memory_order_relaxed) > 0.0;
+    }
+    
+    /**
+     * @brief 尝试取出令牌
+     * @param tokens 令牌数
+     * @return 是否取到
+     */
+    bool tryAcquire(double tokens = 1.0) {
+        double interval = interval_ns_.load(std::memory_order_relaxed);
+        if (interval <= 0.0) {
+            return true;
+        }
+        
+        uint64_t now = nowNanos();
+        uint64_t cost = static_cast<uint64_t>(tokens * interval);
+        uint64_t capacity = static_cast<uint64_t>(capacity_ns_.load(std::memory_order_relaxed));
+        uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        uint64_t next;
+        
+        do {
+            uint64_t base = tat > now ? tat : now;
+            next = base + cost;
+            // 桶满时（base == now）总是放行，保证超过容量的单次请求不会永久阻塞
+            if (next - now > capacity && base != now) {
+                return false;
+            }
+        } while (!tat_ns_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+        
+        return true;
+    }
+    
+    /**
+     * @brief 归还已取出的令牌（组合多个桶时，后续桶取令牌失败后回滚）
+     * @param tokens 令牌数
+     */
+    void refund(double tokens = 1.0) {
+        double interval = interval_ns_.load(std::memory_order_relaxed);
+        if (interval <= 0.0) {
+            return;
+        }
+        
+        uint64_t cost = static_cast<uint64_t>(tokens * interval);
+        uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        uint64_t next;
+        do {
+            next = tat > cost ? tat - cost : 0;
+        } while (!tat_ns_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+    }
+    
+    /**
+     * @brief 估算还需等待多久才能取到指定数量的令牌
+     * @param tokens 令牌数
+     * @return 等待时间（纳秒），可立即取到时返回 0
+     */
+    uint64_t waitNanos(double tokens = 1.0) const {
+        double interval = interval_ns_.load(std::memory_order_relaxed);
+        if (interval <= 0.0) {
+            return 0;
+        }
+        
+        uint64_t now = nowNanos();
+        uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        if (tat <= now) {
+            return 0;
+        }
+        
+        uint64_t cost = static_cast<uint64_t>(tokens * interval);
+        uint64_t capacity = static_cast<uint64_t>(capacity_ns_.load(std::memory_order_relaxed));
+        uint64_t next = tat + cost;
+        return next - now > capacity ? next - now - capacity : 0;
+    }
+
+private:
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+    
+    static uint64_t nowNanos() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    
+    std::atomic<double> interval_ns_;   // 每个令牌对应的时间（纳秒）
+    std::atomic<double> capacity_ns_;   // 桶容量对应的时间（纳秒）
+    std::atomic<uint64_t> tat_ns_;      // 理论到达时间（纳秒）
+};
+
+} // namespace cross_platform_websocket
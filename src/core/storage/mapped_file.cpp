@@ -0,0 +1,204 @@
+#include "mapped_file.h"
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace cross_platform_websocket {
+
+MappedFile::MappedFile()
+#ifdef _WIN32
+    : file_handle_(INVALID_HANDLE_VALUE)
+    , mapping_handle_(nullptr)
+#else
+    : fd_(-1)
+#endif
+    , data_(nullptr)
+    , size_(0) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path, size_t size) {
+    close();
+    
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    LARGE_INTEGER current_size;
+    if (!GetFileSizeEx(file, &current_size)) {
+        CloseHandle(file);
+        return false;
+    }
+    size_t mapped_size = static_cast<size_t>(current_size.QuadPart) > size
+        ? static_cast<size_t>(current_size.QuadPart) : size;
+    
+    DWORD high = static_cast<DWORD>((static_cast<uint64_t>(mapped_size) >> 32) & 0xFFFFFFFF);
+    DWORD low = static_cast<DWORD>(static_cast<uint64_t>(mapped_size) & 0xFFFFFFFF);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, high, low, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, mapped_size);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<char*>(view);
+    size_ = mapped_size;
+    path_ = path;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        FlushViewOfFile(data_, 0);
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_handle_) {
+        CloseHandle(mapping_handle_);
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_handle_);
+        file_handle_ = INVALID_HANDLE_VALUE;
+    }
+    size_ = 0;
+}
+
+bool MappedFile::flush(size_t offset, size_t length, bool sync) {
+    if (!data_ || offset >= size_) {
+        return false;
+    }
+    if (offset + length > size_) {
+        length = size_ - offset;
+    }
+    if (!FlushViewOfFile(data_ + offset, length)) {
+        return false;
+    }
+    return !sync || FlushFileBuffers(file_handle_);
+}
+
+bool MappedFile::createDirectory(const std::string& path) {
+    return CreateDirectoryA(path.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+bool MappedFile::exists(const std::string& path) {
+    return GetFileAttributesA(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+bool MappedFile::truncate(const std::string& path, size_t size) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(size);
+    bool ok = SetFilePointerEx(file, position, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+    CloseHandle(file);
+    return ok;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path, size_t size) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t mapped_size = static_cast<size_t>(st.st_size) > size ? static_cast<size_t>(st.st_size) : size;
+    if (static_cast<size_t>(st.st_size) < mapped_size && ftruncate(fd, mapped_size) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    void* addr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    
+    fd_ = fd;
+    data_ = static_cast<char*>(addr);
+    size_ = mapped_size;
+    path_ = path;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+bool MappedFile::flush(size_t offset, size_t length, bool sync) {
+    if (!data_ || offset >= size_) {
+        return false;
+    }
+    if (offset + length > size_) {
+        length = size_ - offset;
+    }
+    
+    // msync 要求起始地址按页对齐
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t aligned_offset = offset - (offset % page_size);
+    length += offset - aligned_offset;
+    
+    return msync(data_ + aligned_offset, length, sync ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+bool MappedFile::createDirectory(const std::string& path) {
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool MappedFile::exists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+bool MappedFile::truncate(const std::string& path, size_t size) {
+    return ::truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+}
+
+#endif
+
+} // namespace cross_platform_websocket
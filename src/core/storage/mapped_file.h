@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 内存映射文件
+ * 
+ * 以读写方式将固定大小的文件映射到内存，文件不存在时创建并预分配到指定大小。
+ * 写入映射区域即写入页缓存，进程崩溃后数据仍保留在文件中；
+ * 需要落盘保证时调用 flush。
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    /**
+     * @brief 打开并映射文件
+     * @param path 文件路径
+     * @param size 映射大小（文件小于该大小时扩展）
+     * @return 是否成功
+     */
+    bool open(const std::string& path, size_t size);
+    
+    /**
+     * @brief 解除映射并关闭文件
+     */
+    void close();
+    
+    /**
+     * @brief 将映射区域的一段刷新到磁盘
+     * @param offset 起始偏移
+     * @param length 长度
+     * @param sync 是否等待写入完成
+     * @return 是否成功
+     */
+    bool flush(size_t offset, size_t length, bool sync);
+    
+    /**
+     * @brief 检查是否已映射
+     * @return 是否已映射
+     */
+    bool isOpen() const { return data_ != nullptr; }
+    
+    char* data() { return data_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+    
+    /**
+     * @brief 创建目录（已存在时视为成功）
+     * @param path 目录路径
+     * @return 是否成功
+     */
+    static bool createDirectory(const std::string& path);
+    
+    /**
+     * @brief 检查文件是否存在
+     * @param path 文件路径
+     * @return 是否存在
+     */
+    static bool exists(const std::string& path);
+    
+    /**
+     * @brief 将未映射的文件截断到指定大小
+     * @param path 文件路径
+     * @param size 新大小
+     * @return 是否成功
+     */
+    static bool truncate(const std::string& path, size_t size);
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+#ifdef _WIN32
+    void* file_handle_;
+    void* mapping_handle_;
+#else
+    int fd_;
+#endif
+    char* data_;
+    size_t size_;
+    std::string path_;
+};
+
+} // namespace cross_platform_websocket
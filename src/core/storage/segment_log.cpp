@@ -0,0 +1,346 @@
+#include "segment_log.h"
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdio>
+
+namespace cross_platform_websocket {
+
+namespace {
+
+const uint64_t kSegmentMagic = 0x31474F4C51535357ULL;  // "WSSQLOG1"
+const size_t kSegmentHeaderSize = 64;
+const uint32_t kRecordMagic = 0x514D5357;              // "WSMQ"
+const uint8_t kRecordPending = 1;
+const uint8_t kRecordConsumed = 2;
+
+/**
+ * @brief 记录头，固定 32 字节
+ */
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t length;
+    uint64_t timestamp;
+    uint8_t type;
+    uint8_t priority;
+    uint8_t state;
+    uint8_t reserved0;
+    uint16_t key_length;   // 负载开头的键长度
+    uint8_t reserved[10];
+};
+
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader must be 32 bytes");
+
+const size_t kStateOffset = offsetof(RecordHeader, state);
+
+size_t alignRecord(size_t length) {
+    return (length + 7) & ~static_cast<size_t>(7);
+}
+
+void writeTerminator(MappedFile& file, size_t offset) {
+    if (offset + sizeof(uint32_t) <= file.size()) {
+        uint32_t zero = 0;
+        std::memcpy(file.data() + offset, &zero, sizeof(zero));
+    }
+}
+
+} // namespace
+
+const uint64_t SegmentLog::kInvalidPosition = ~static_cast<uint64_t>(0);
+
+SegmentLog::SegmentLog()
+    : active_(0)
+    , next_sequence_(1)
+    , appends_since_sync_(0)
+    , sync_begin_(kSegmentHeaderSize) {
+}
+
+SegmentLog::~SegmentLog() {
+    close();
+}
+
+bool SegmentLog::open(const SegmentLogOptions& options, ReplayCallback replay) {
+    close();
+    options_ = options;
+    
+    if (options_.segment_size < kSegmentHeaderSize + 2 * sizeof(RecordHeader) ||
+        options_.segment_size > 0xFFFFFFFFULL) {
+        return false;
+    }
+    if (!MappedFile::createDirectory(options_.directory)) {
+        return false;
+    }
+    
+    // 段文件按下标连续编号，探测已有的段文件
+    for (size_t index = 0; MappedFile::exists(segmentPath(index)); ++index) {
+        if (!openSegment(index)) {
+            close();
+            return false;
+        }
+    }
+    
+    // 按段序号顺序扫描，保证回放顺序与追加顺序一致
+    std::vector<size_t> order;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        if (segments_[i].sequence != 0) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return segments_[a].sequence < segments_[b].sequence;
+    });
+    
+    for (size_t index : order) {
+        scanSegment(index, replay);
+        next_sequence_ = std::max(next_sequence_, segments_[index].sequence + 1);
+    }
+    
+    if (!order.empty()) {
+        // 继续追加到序号最大的段
+        active_ = order.back();
+        for (size_t index : order) {
+            if (index != active_ && segments_[index].live_records == 0) {
+                recycle(index);
+            }
+        }
+    } else {
+        if (segments_.empty() && !openSegment(0)) {
+            close();
+            return false;
+        }
+        active_ = 0;
+        resetSegment(active_, next_sequence_++);
+    }
+    
+    sync_begin_ = segments_[active_].write_offset;
+    appends_since_sync_ = 0;
+    return true;
+}
+
+void SegmentLog::close() {
+    if (!segments_.empty()) {
+        sync();
+    }
+    segments_.clear();
+    active_ = 0;
+    next_sequence_ = 1;
+}
+
+bool SegmentLog::append(uint8_t type, uint8_t priority, uint64_t timestamp,
+                        const char* data, size_t length, uint64_t& position,
+                        const std::string& key) {
+    if (!isOpen() || key.size() > 0xFFFF || key.size() + length > maxRecordLength()) {
+        return false;
+    }
+    
+    size_t payload_length = key.size() + length;
+    size_t total = alignRecord(sizeof(RecordHeader) + payload_length);
+    if (segments_[active_].write_offset + total > segments_[active_].file->size() && !rotate()) {
+        return false;
+    }
+    
+    Segment& segment = segments_[active_];
+    char* base = segment.file->data() + segment.write_offset;
+    
+    // 先写负载和新的结束标记，最后写带魔数的记录头，保证扫描时不会读到半条记录
+    if (!key.empty()) {
+        std::memcpy(base + sizeof(RecordHeader), key.data(), key.size());
+    }
+    if (length > 0) {
+        std::memcpy(base + sizeof(RecordHeader) + key.size(), data, length);
+    }
+    writeTerminator(*segment.file, segment.write_offset + total);
+    
+    RecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.length = static_cast<uint32_t>(payload_length);
+    header.key_length = static_cast<uint16_t>(key.size());
+    header.timestamp = timestamp;
+    header.type = type;
+    header.priority = priority;
+    header.state = kRecordPending;
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(base, &kRecordMagic, sizeof(kRecordMagic));
+    
+    position = (static_cast<uint64_t>(active_) << 32) | segment.write_offset;
+    segment.write_offset += total;
+    segment.live_records++;
+    
+    if (options_.sync_every > 0 && ++appends_since_sync_ >= options_.sync_every) {
+        sync();
+    }
+    return true;
+}
+
+void SegmentLog::markConsumed(uint64_t position) {
+    if (!isOpen() || position == kInvalidPosition) {
+        return;
+    }
+    
+    size_t index = static_cast<size_t>(position >> 32);
+    size_t offset = static_cast<size_t>(position & 0xFFFFFFFFULL);
+    if (index >= segments_.size() || offset + sizeof(RecordHeader) > segments_[index].write_offset) {
+        return;
+    }
+    
+    Segment& segment = segments_[index];
+    char* state = segment.file->data() + offset + kStateOffset;
+    if (*state != kRecordPending) {
+        return;
+    }
+    *state = static_cast<char>(kRecordConsumed);
+    
+    if (--segment.live_records == 0) {
+        if (index == active_) {
+            // 当前写入段已全部消费，原地回绕复用
+            resetSegment(active_, segment.sequence);
+            sync_begin_ = segment.write_offset;
+        } else {
+            recycle(index);
+        }
+    }
+}
+
+bool SegmentLog::sync() {
+    if (!isOpen()) {
+        return false;
+    }
+    
+    Segment& segment = segments_[active_];
+    size_t begin = std::min(sync_begin_, segment.write_offset);
+    size_t end = std::min(segment.write_offset + sizeof(uint32_t), segment.file->size());
+    appends_since_sync_ = 0;
+    sync_begin_ = segment.write_offset;
+    
+    // 同步记录区域及段头
+    bool ok = segment.file->flush(0, kSegmentHeaderSize, options_.sync_every > 0);
+    if (end > begin) {
+        ok = segment.file->flush(begin, end - begin, options_.sync_every > 0) && ok;
+    }
+    return ok;
+}
+
+size_t SegmentLog::pendingRecords() const {
+    size_t count = 0;
+    for (const auto& segment : segments_) {
+        count += segment.live_records;
+    }
+    return count;
+}
+
+size_t SegmentLog::maxRecordLength() const {
+    return options_.segment_size - kSegmentHeaderSize - sizeof(RecordHeader) - sizeof(uint32_t);
+}
+
+std::string SegmentLog::segmentPath(size_t index) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment_%06u.dat", static_cast<unsigned>(index));
+    return options_.directory + "/" + name;
+}
+
+bool SegmentLog::openSegment(size_t index) {
+    Segment segment;
+    segment.file = std::unique_ptr<MappedFile>(new MappedFile());
+    if (!segment.file->open(segmentPath(index), options_.segment_size)) {
+        return false;
+    }
+    
+    uint64_t magic = 0;
+    std::memcpy(&magic, segment.file->data(), sizeof(magic));
+    std::memcpy(&segment.sequence, segment.file->data() + sizeof(magic), sizeof(segment.sequence));
+    segment.write_offset = kSegmentHeaderSize;
+    segment.live_records = 0;
+    
+    if (segments_.size() <= index) {
+        segments_.resize(index + 1);
+    }
+    segments_[index] = std::move(segment);
+    
+    if (magic != kSegmentMagic) {
+        // 新建或无法识别的段文件，视为空闲段
+        resetSegment(index, 0);
+    }
+    return true;
+}
+
+void SegmentLog::scanSegment(size_t index, ReplayCallback& replay) {
+    Segment& segment = segments_[index];
+    const char* base = segment.file->data();
+    size_t size = segment.file->size();
+    size_t offset = kSegmentHeaderSize;
+    
+    while (offset + sizeof(RecordHeader) <= size) {
+        RecordHeader header;
+        std::memcpy(&header, base + offset, sizeof(header));
+        if (header.magic != kRecordMagic || header.key_length > header.length ||
+            offset + sizeof(RecordHeader) + header.length > size) {
+            break;
+        }
+        
+        if (header.state == kRecordPending) {
+            segment.live_records++;
+            if (replay) {
+                SegmentLogRecord record;
+                record.position = (static_cast<uint64_t>(index) << 32) | offset;
+                record.type = header.type;
+                record.priority = header.priority;
+                record.timestamp = header.timestamp;
+                record.key = base + offset + sizeof(RecordHeader);
+                record.key_length = header.key_length;
+                record.data = record.key + header.key_length;
+                record.length = header.length - header.key_length;
+                replay(record);
+            }
+        }
+        offset += alignRecord(sizeof(RecordHeader) + header.length);
+    }
+    
+    segment.write_offset = std::min(offset, size);
+}
+
+void SegmentLog::resetSegment(size_t index, uint64_t sequence) {
+    Segment& segment = segments_[index];
+    char* base = segment.file->data();
+    std::memcpy(base, &kSegmentMagic, sizeof(kSegmentMagic));
+    std::memcpy(base + sizeof(kSegmentMagic), &sequence, sizeof(sequence));
+    writeTerminator(*segment.file, kSegmentHeaderSize);
+    
+    segment.sequence = sequence;
+    segment.write_offset = kSegmentHeaderSize;
+    segment.live_records = 0;
+}
+
+bool SegmentLog::rotate() {
+    sync();
+    
+    // 优先复用空闲段
+    size_t next = segments_.size();
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        if (i != active_ && segments_[i].sequence == 0) {
+            next = i;
+            break;
+        }
+    }
+    
+    if (next == segments_.size()) {
+        if (options_.max_segments > 0 && segments_.size() >= options_.max_segments) {
+            return false;
+        }
+        if (!openSegment(next)) {
+            return false;
+        }
+    }
+    
+    resetSegment(next, next_sequence_++);
+    active_ = next;
+    sync_begin_ = kSegmentHeaderSize;
+    appends_since_sync_ = 0;
+    return true;
+}
+
+void SegmentLog::recycle(size_t index) {
+    resetSegment(index, 0);
+    segments_[index].file->flush(0, kSegmentHeaderSize, false);
+}
+
+} // namespace cross_platform_websocket
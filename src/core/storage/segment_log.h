@@ -0,0 +1,153 @@
+#pragma once
+
+#include "mapped_file.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+namespace cross_platform_websocket {
+
+/**
+ * @brief 分段日志配置
+ */
+struct SegmentLogOptions {
+    std::string directory;  // 段文件所在目录
+    size_t segment_size;    // 单个段文件大小（字节）
+    size_t max_segments;    // 最大段文件数（0 表示不限制）
+    size_t sync_every;      // 每追加多少条记录同步一次（0 表示交由操作系统回写）
+    
+    SegmentLogOptions()
+        : segment_size(4 * 1024 * 1024)
+        , max_segments(0)
+        , sync_every(0) {}
+};
+
+/**
+ * @brief 从分段日志中恢复的记录
+ */
+struct SegmentLogRecord {
+    uint64_t position;   // 记录位置，用于 markConsumed
+    uint8_t type;
+    uint8_t priority;
+    uint64_t timestamp;
+    const char* key;
+    size_t key_length;
+    const char* data;
+    size_t length;
+};
+
+/**
+ * @brief 基于内存映射的分段追加日志
+ * 
+ * 记录顺序追加到固定大小、预分配的段文件中，每条记录带有状态字节：
+ * 消费后原地标记为已消费，段内记录全部消费后该段被回收复用。
+ * 打开时扫描段文件重建每段的存活记录数，并按追加顺序回放未消费的记录。
+ * 
+ * 段文件格式：
+ *   段头（64 字节）：魔数、段序号（0 表示空闲段）
+ *   记录：32 字节记录头 + 键 + 负载，按 8 字节对齐；魔数为 0 处表示段内数据结束
+ * 
+ * 本类不做同步，由调用方加锁。
+ */
+class SegmentLog {
+public:
+    /**
+     * @brief 无效的记录位置
+     */
+    static const uint64_t kInvalidPosition;
+    
+    using ReplayCallback = std::function<void(const SegmentLogRecord& record)>;
+    
+    SegmentLog();
+    ~SegmentLog();
+    
+    /**
+     * @brief 打开日志目录并回放未消费的记录
+     * @param options 配置
+     * @param replay 对每条未消费记录按追加顺序调用
+     * @return 是否成功
+     */
+    bool open(const SegmentLogOptions& options, ReplayCallback replay);
+    
+    /**
+     * @brief 同步并关闭所有段文件（未消费记录保留在磁盘上）
+     */
+    void close();
+    
+    /**
+     * @brief 检查是否已打开
+     * @return 是否已打开
+     */
+    bool isOpen() const { return !segments_.empty(); }
+    
+    /**
+     * @brief 追加一条记录
+     * @param type 记录类型
+     * @param priority 记录优先级
+     * @param timestamp 时间戳
+     * @param data 负载
+     * @param length 负载长度
+     * @param position 输出记录位置
+     * @param key 记录键（可为空，与负载一同存储）
+     * @return 段空间不足或超过段数上限时返回 false
+     */
+    bool append(uint8_t type, uint8_t priority, uint64_t timestamp,
+                const char* data, size_t length, uint64_t& position,
+                const std::string& key = std::string());
+    
+    /**
+     * @brief 将记录标记为已消费
+     * @param position 记录位置
+     */
+    void markConsumed(uint64_t position);
+    
+    /**
+     * @brief 将当前写入段同步到磁盘
+     * @return 是否成功
+     */
+    bool sync();
+    
+    /**
+     * @brief 获取未消费的记录数
+     * @return 记录数
+     */
+    size_t pendingRecords() const;
+    
+    /**
+     * @brief 获取段文件数
+     * @return 段文件数
+     */
+    size_t segmentCount() const { return segments_.size(); }
+    
+    /**
+     * @brief 单条记录可容纳的最大负载
+     * @return 字节数
+     */
+    size_t maxRecordLength() const;
+
+private:
+    struct Segment {
+        std::unique_ptr<MappedFile> file;
+        uint64_t sequence;     // 段序号，0 表示空闲
+        size_t write_offset;   // 下一条记录的写入偏移
+        size_t live_records;   // 未消费的记录数
+    };
+    
+    SegmentLogOptions options_;
+    std::vector<Segment> segments_;
+    size_t active_;              // 当前写入段下标
+    uint64_t next_sequence_;     // 下一个段序号
+    size_t appends_since_sync_;
+    size_t sync_begin_;          // 当前写入段中尚未同步区域的起点
+    
+    std::string segmentPath(size_t index) const;
+    bool openSegment(size_t index);
+    void scanSegment(size_t index, ReplayCallback& replay);
+    void resetSegment(size_t index, uint64_t sequence);
+    bool rotate();
+    void recycle(size_t index);
+};
+
+} // namespace cross_platform_websocket
@@ -19,6 +19,7 @@ NativePlatform::NativePlatform()
     : websocket_context_(nullptr)
     , websocket_connection_(nullptr)
     , is_connected_(false)
+    , internal_log_level_(0)
     , random_generator_(random_device_()) {
     
     initializeNetwork();
@@ -29,22 +30,37 @@ NativePlatform::~NativePlatform() {
     cleanupNetwork();
 }
 
+// 内部日志级别（与 LogLevel 取值相同）；构造时初始化网络库的日志早于级别设置，照常输出
+static const int kTraceDebug = 0;
+static const int kTraceInfo = 1;
+static const int kTraceWarning = 2;
+static const int kTraceError = 3;
+
 // ==================== 日志接口实现 ====================
 
+// 日志只写入缓冲区，由 logFlush 统一刷新（std::cerr 本身不缓冲）
 void NativePlatform::logInfo(const std::string& message) {
-    std::cout << "[INFO] " << message << std::endl;
+    std::cout << "[INFO] " << message << '\n';
 }
 
 void NativePlatform::logError(const std::string& message) {
-    std::cerr << "[ERROR] " << message << std::endl;
+    std::cerr << "[ERROR] " << message << '\n';
 }
 
 void NativePlatform::logDebug(const std::string& message) {
-    std::cout << "[DEBUG] " << message << std::endl;
+    std::cout << "[DEBUG] " << message << '\n';
 }
 
 void NativePlatform::logWarning(const std::string& message) {
-    std::cout << "[WARNING] " << message << std::endl;
+    std::cout << "[WARNING] " << message << '\n';
+}
+
+void NativePlatform::logFlush() {
+    std::cout.flush();
+}
+
+void NativePlatform::setInternalLogLevel(int level) {
+    internal_log_level_.store(level, std::memory_order_relaxed);
 }
 
 // ==================== WebSocket 接口实现 ====================
@@ -53,19 +69,25 @@ bool NativePlatform::websocketConnect(const std::string& url) {
     std::lock_guard<std::mutex> lock(websocket_mutex_);
     
     if (is_connected_) {
-        logWarning("WebSocket 已经连接");
+        if (traceEnabled(kTraceWarning)) {
+            logWarning("WebSocket 已经连接");
+        }
         return true;
     }
     
     // 这里应该使用 libwebsockets 实现 WebSocket 连接
     // 为了演示，我们只是模拟连接过程
-    logInfo("正在连接到: " + url);
+    if (traceEnabled(kTraceInfo)) {
+        logInfo("正在连接到: " + url);
+    }
     
     // 模拟连接延迟
     sleep(100);
     
     is_connected_ = true;
-    logInfo("WebSocket 连接成功");
+    if (traceEnabled(kTraceInfo)) {
+        logInfo("WebSocket 连接成功");
+    }
     return true;
 }
 
@@ -73,12 +95,65 @@ bool NativePlatform::websocketSend(const std::string& message) {
     std::lock_guard<std::mutex> lock(websocket_mutex_);
     
     if (!is_connected_) {
-        logError("WebSocket 未连接，无法发送消息");
+        if (traceEnabled(kTraceError)) {
+            logError("WebSocket 未连接，无法发送消息");
+        }
         return false;
     }
     
     // 这里应该使用 libwebsockets 发送消息
-    logInfo("发送消息: " + message);
+    if (traceEnabled(kTraceDebug)) {
+        logDebug("发送消息: " + message);
+    }
+    return true;
+}
+
+bool NativePlatform::websocketSendBinary(const uint8_t* data, size_t length) {
+    return websocketSendData(reinterpret_cast<const char*>(data), length, true);
+}
+
+bool NativePlatform::websocketSendData(const char* data, size_t length, bool is_binary) {
+    std::lock_guard<std::mutex> lock(websocket_mutex_);
+    
+    if (!is_connected_) {
+        if (traceEnabled(kTraceError)) {
+            logError("WebSocket 未连接，无法发送消息");
+        }
+        return false;
+    }
+    
+    // 这里应该使用 libwebsockets 发送消息（LWS_WRITE_TEXT/LWS_WRITE_BINARY）
+    (void)data;
+    if (traceEnabled(kTraceDebug)) {
+        logDebug(std::string(is_binary ? "发送二进制消息: " : "发送消息: ") +
+                 std::to_string(length) + " 字节");
+    }
+    return true;
+}
+
+bool NativePlatform::websocketSupportsFragments() {
+    return true;
+}
+
+bool NativePlatform::websocketSendFragment(const char* fragment, size_t length, bool is_binary,
+                                           bool is_first, bool is_final) {
+    std::lock_guard<std::mutex> lock(websocket_mutex_);
+    
+    if (!is_connected_) {
+        if (traceEnabled(kTraceError)) {
+            logError("WebSocket 未连接，无法发送分片");
+        }
+        return false;
+    }
+    
+    // 这里应该使用 libwebsockets 发送分片：首片使用 LWS_WRITE_TEXT/LWS_WRITE_BINARY，
+    // 后续分片使用 LWS_WRITE_CONTINUATION，非末片附加 LWS_WRITE_NO_FIN
+    (void)fragment;
+    (void)is_binary;
+    if (traceEnabled(kTraceDebug)) {
+        logDebug("发送分片: " + std::to_string(length) + " 字节" +
+                 (is_first ? "，首片" : "") + (is_final ? "，末片" : ""));
+    }
     return true;
 }
 
@@ -90,7 +165,9 @@ void NativePlatform::websocketClose() {
     }
     
     // 这里应该使用 libwebsockets 关闭连接
-    logInfo("关闭 WebSocket 连接");
+    if (traceEnabled(kTraceInfo)) {
+        logInfo("关闭 WebSocket 连接");
+    }
     is_connected_ = false;
 }
 
@@ -198,7 +275,9 @@ void NativePlatform::cleanupNetwork() {
 #ifdef _WIN32
     WSACleanup();
 #endif
-    logInfo("网络库清理完成");
+    if (traceEnabled(kTraceInfo)) {
+        logInfo("网络库清理完成");
+    }
 }
 
 } // namespace cross_platform_websocket 
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <map>
 #include <chrono>
 #include <random>
+#include <atomic>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -37,10 +38,17 @@ public:
     void logError(const std::string& message) override;
     void logDebug(const std::string& message) override;
     void logWarning(const std::string& message) override;
+    void logFlush() override;
+    void setInternalLogLevel(int level) override;
     
     // ==================== WebSocket 接口实现 ====================
     bool websocketConnect(const std::string& url) override;
     bool websocketSend(const std::string& message) override;
+    bool websocketSendBinary(const uint8_t* data, size_t length) override;
+    bool websocketSendData(const char* data, size_t length, bool is_binary) override;
+    bool websocketSupportsFragments() override;
+    bool websocketSendFragment(const char* fragment, size_t length, bool is_binary,
+                               bool is_first, bool is_final) override;
     void websocketClose() override;
     bool websocketIsConnected() override;
     
@@ -66,6 +74,18 @@ private:
     bool is_connected_;
     std::mutex websocket_mutex_;
     
+    // 内部日志的最低级别（与 LogLevel 取值相同）
+    std::atomic<int> internal_log_level_;
+    
+    /**
+     * @brief 检查内部日志是否输出指定级别
+     * @param level 级别
+     * @return 是否输出
+     */
+    bool traceEnabled(int level) const {
+        return level >= internal_log_level_.load(std::memory_order_relaxed);
+    }
+    
     // 配置相关
     std::map<std::string, std::string> config_map_;
     std::mutex config_mutex_;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <functional>
 
@@ -42,6 +43,24 @@ public:
      */
     virtual void logWarning(const std::string& message) = 0;
     
+    /**
+     * @brief 刷新日志输出
+     * 
+     * 日志函数可以只写入缓冲区，由 Logger 在每条（同步模式）或每批（异步模式）之后调用本函数。
+     * 默认实现为空，适用于逐条直接输出的平台。
+     */
+    virtual void logFlush() {}
+    
+    /**
+     * @brief 设置平台实现内部日志（连接、收发跟踪等）的最低级别
+     * 
+     * 由 Logger 按 PLATFORM 模块的级别调用；级别取值与 LogLevel 相同（0=DEBUG ... 3=ERROR，4=关闭）。
+     * 默认实现为空，适用于没有内部日志的平台。
+     * 
+     * @param level 最低级别
+     */
+    virtual void setInternalLogLevel(int /*level*/) {}
+    
     // ==================== WebSocket 接口 ====================
     
     /**
@@ -58,6 +77,61 @@ public:
      */
     virtual bool websocketSend(const std::string& message) = 0;
     
+    /**
+     * @brief 发送 WebSocket 二进制消息
+     * 
+     * 默认实现复制为字符串后调用 websocketSend，平台应覆盖以发送二进制帧。
+     * 
+     * @param data 数据指针
+     * @param length 字节数
+     * @return 是否发送成功
+     */
+    virtual bool websocketSendBinary(const uint8_t* data, size_t length) {
+        return websocketSend(std::string(reinterpret_cast<const char*>(data), length));
+    }
+    
+    /**
+     * @brief 发送一段连续内存中的 WebSocket 消息
+     * 
+     * 供内存池中的负载直接写入传输层，避免复制为 std::string。
+     * 默认实现按消息类型分派到 websocketSendBinary 或 websocketSend。
+     * 
+     * @param data 数据指针
+     * @param length 字节数
+     * @param is_binary 是否为二进制消息
+     * @return 是否发送成功
+     */
+    virtual bool websocketSendData(const char* data, size_t length, bool is_binary) {
+        if (is_binary) {
+            return websocketSendBinary(reinterpret_cast<const uint8_t*>(data), length);
+        }
+        return websocketSend(std::string(data, length));
+    }
+    
+    /**
+     * @brief 检查平台是否支持分片发送（continuation 帧）
+     * @return 是否支持
+     */
+    virtual bool websocketSupportsFragments() { return false; }
+    
+    /**
+     * @brief 以分片方式发送一条消息的一部分
+     * 
+     * 同一消息的分片必须按顺序连续发送，分片之间只允许插入控制帧（RFC 6455 第 5.4 节）。
+     * 默认实现只支持不分片的完整消息（首片同时也是末片）。
+     * 
+     * @param fragment 分片数据指针
+     * @param length 分片字节数
+     * @param is_binary 是否为二进制消息（仅首片使用）
+     * @param is_first 是否为首片
+     * @param is_final 是否为末片
+     * @return 是否发送成功
+     */
+    virtual bool websocketSendFragment(const char* fragment, size_t length, bool is_binary,
+                                       bool is_first, bool is_final) {
+        return is_first && is_final && websocketSendData(fragment, length, is_binary);
+    }
+    
     /**
      * @brief 关闭 WebSocket 连接
      */
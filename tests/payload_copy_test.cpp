@@ -0,0 +1,186 @@
+/**
+ * @file payload_copy_test.cpp
+ * @brief 移动发送的负载零复制测试
+ * 
+ * 以移动方式发送 Payload 时，负载缓冲区应从调用方一路移交到传输层，
+ * 不经过内存池重新分配，也不复制内容。分别验证离线入队后由发送线程发出
+ * 和已连接时直接发送两条路径：发送前后比较 BufferPool 的分配次数，
+ * 并检查传输层收到的数据地址就是调用方原先持有的缓冲区。
+ * 
+ * 传输层由记录写入的测试平台代替，不依赖 libwebsockets 和网络。
+ */
+
+#include "api/cpp/websocket_api.h"
+#include "core/memory/buffer_pool.h"
+#include "platform/native_platform.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace cross_platform_websocket;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "检查失败 [" << __FILE__ << ":" << __LINE__ << "] " << #condition << std::endl; \
+            g_failures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief 记录传输层写入的测试平台
+ * 
+ * 连接立即成功，每次写入只记录数据地址和长度，不复制内容。
+ */
+class RecordingPlatform : public NativePlatform {
+public:
+    struct Write {
+        const char* data;
+        size_t length;
+    };
+    
+    RecordingPlatform() : connected_(false) {}
+    
+    bool websocketConnect(const std::string& /*url*/) override {
+        connected_.store(true);
+        return true;
+    }
+    
+    bool websocketSend(const std::string& message) override {
+        return record(message.data(), message.size());
+    }
+    
+    bool websocketSendData(const char* data, size_t length, bool /*is_binary*/) override {
+        return record(data, length);
+    }
+    
+    void websocketClose() override {
+        connected_.store(false);
+    }
+    
+    bool websocketIsConnected() override {
+        return connected_.load();
+    }
+    
+    /**
+     * @brief 查找长度为 length 的写入，返回其数据地址（未找到时返回 nullptr）
+     */
+    const char* findWrite(size_t length) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& write : writes_) {
+            if (write.length == length) {
+                return write.data;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    bool record(const char* data, size_t length) {
+        if (!connected_.load()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        Write write;
+        write.data = data;
+        write.length = length;
+        writes_.push_back(write);
+        return true;
+    }
+    
+    std::atomic<bool> connected_;
+    std::mutex mutex_;
+    std::vector<Write> writes_;
+};
+
+/**
+ * @brief 离线入队，连接后由发送线程发出
+ */
+void testQueuedSend() {
+    auto platform = std::make_shared<RecordingPlatform>();
+    WebSocketAPI api(platform);
+    CHECK(api.initialize());
+    api.enableMessageQueue(true, 10);
+    
+    const size_t size = 4000;
+    Payload payload(std::string(size, 'q'));
+    const char* address = payload.data();
+    CHECK(!payload.isInline());
+    
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> done = promise->get_future();
+    
+    BufferPoolStats before = BufferPool::instance().getStats();
+    CHECK(api.sendText(std::move(payload), [promise](bool success, const std::string&) {
+        promise->set_value(success);
+    }));
+    CHECK(payload.empty());
+    
+    CHECK(api.connect("ws://test", false));
+    CHECK(done.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    CHECK(done.get());
+    BufferPoolStats after = BufferPool::instance().getStats();
+    
+    CHECK(after.allocations == before.allocations);
+    CHECK(platform->findWrite(size) == address);
+    
+    api.disconnect();
+}
+
+/**
+ * @brief 已连接时直接发送（内存池缓冲区和对象内存储两种负载）
+ */
+void testDirectSend() {
+    auto platform = std::make_shared<RecordingPlatform>();
+    WebSocketAPI api(platform);
+    CHECK(api.initialize());
+    CHECK(api.connect("ws://test", false));
+    
+    const size_t size = 3000;
+    Payload pooled(std::string(size, 'd'));
+    const char* address = pooled.data();
+    CHECK(!pooled.isInline());
+    
+    BufferPoolStats before = BufferPool::instance().getStats();
+    CHECK(api.sendBinary(std::move(pooled)));
+    BufferPoolStats after = BufferPool::instance().getStats();
+    
+    // 直接发送时传输层就地写出调用方的缓冲区
+    CHECK(after.allocations == before.allocations);
+    CHECK(platform->findWrite(size) == address);
+    
+    // 对象内存储的小负载：移动时复制不超过 kInlineCapacity 字节，但不应向内存池申请
+    Payload small(std::string(100, 's'));
+    CHECK(small.isInline());
+    before = BufferPool::instance().getStats();
+    CHECK(api.sendText(std::move(small)));
+    after = BufferPool::instance().getStats();
+    
+    CHECK(after.allocations == before.allocations);
+    CHECK(platform->findWrite(100) != nullptr);
+    
+    api.disconnect();
+}
+
+} // namespace
+
+int main() {
+    testQueuedSend();
+    testDirectSend();
+    
+    if (g_failures > 0) {
+        std::cerr << "失败: " << g_failures << " 项" << std::endl;
+        return 1;
+    }
+    std::cout << "负载零复制测试通过" << std::endl;
+    return 0;
+}
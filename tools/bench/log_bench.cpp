@@ -0,0 +1,204 @@
+/**
+ * @file log_bench.cpp
+ * @brief 文本日志格式化基准测试
+ * 
+ * 对比原先的格式化方式（每条记录调用 std::localtime、ostringstream + put_time、
+ * 运行时从完整 __FILE__ 路径截取文件名）与现在的 Logger：每线程缓存当前秒的时间前缀，
+ * 日志宏在编译期去掉目录、只传文件名。分别测量单独格式化和经 Logger 写入丢弃输出的耗时，
+ * 多线程时各线程同时记录，反映 std::localtime 内部加锁的影响。
+ * 
+ * 用法: ws_log_bench [每线程记录数] [线程数] [轮数]
+ */
+
+#include "core/logger/logger.h"
+#include "platform/native_platform.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cross_platform_websocket;
+
+namespace {
+
+// 典型的构建目录下的 __FILE__（原先的日志宏直接传入完整路径）
+const char* const kFullPath = "/home/build/workspace/cross_platform_websocket/src/business/websocket_manager.cpp";
+const char* const kMessage = "队列消息发送成功，大小: 128 字节";
+const int kLine = 812;
+
+/**
+ * @brief 原先的 Logger::format 实现
+ */
+std::string legacyFormat(LogLevel level, const std::string& message, const std::string& file, int line) {
+    std::ostringstream oss;
+    
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now.time_since_epoch()) % 1000;
+    
+    std::tm* tm = std::localtime(&time_t);
+    
+    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
+    oss << "." << std::setfill('0') << std::setw(3) << ms.count();
+    
+    oss << " [" << std::string(level == LogLevel::INFO ? "INFO" : "DEBUG") << "] ";
+    
+    if (!file.empty() && line > 0) {
+        size_t pos = file.find_last_of("/\\");
+        std::string filename = (pos != std::string::npos) ? file.substr(pos + 1) : file;
+        oss << "[" << filename << ":" << line << "] ";
+    }
+    
+    oss << message;
+    return oss.str();
+}
+
+/**
+ * @brief 丢弃所有日志的输出目标，只统计字节数
+ */
+class NullSink : public LogSink {
+public:
+    NullSink() : bytes_(0) {}
+    
+    void write(LogLevel /*level*/, const char* /*text*/, size_t length) override {
+        bytes_.fetch_add(length, std::memory_order_relaxed);
+    }
+    
+    size_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<size_t> bytes_;
+};
+
+/**
+ * @brief 在指定线程数上同时运行 body，返回总墙钟时间除以总记录数（纳秒）
+ */
+double runThreads(int threads, size_t count, const std::function<void(size_t&)>& body, size_t& checksum) {
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<size_t> sums(static_cast<size_t>(threads), 0);
+    std::vector<std::thread> workers;
+    
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                body(sums[static_cast<size_t>(t)]);
+            }
+        });
+    }
+    
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    
+    for (size_t sum : sums) {
+        checksum += sum;
+    }
+    return static_cast<double>(elapsed) / static_cast<double>(count * static_cast<size_t>(threads));
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+void printRow(const char* name, const std::vector<double>& values) {
+    std::cout << std::fixed << std::setprecision(1) << std::setw(10) << median(values)
+              << " ns/条  " << name << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 200000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 5;
+    if (count == 0 || threads <= 0 || rounds <= 0) {
+        std::cerr << "用法: " << argv[0] << " [每线程记录数] [线程数] [轮数]" << std::endl;
+        return 2;
+    }
+    
+    auto platform = std::make_shared<NativePlatform>();
+    auto logger = std::make_shared<Logger>(platform);
+    auto sink = std::make_shared<NullSink>();
+    logger->setConsoleOutput(false);
+    logger->setLogLevel(LogLevel::DEBUG);
+    logger->addSink(sink);
+    
+    const std::string message(kMessage);
+    const char* base_name = logBaseName(kFullPath);
+    size_t checksum = 0;
+    
+    std::vector<double> legacy_format;
+    std::vector<double> cached_format;
+    std::vector<double> cached_format_full_path;
+    std::vector<double> legacy_log;
+    std::vector<double> cached_log;
+    
+    // 原先的 Logger::log 路径：宏把完整 __FILE__ 构造为 std::string，再按旧方式格式化
+    auto legacy_write = [&](size_t& sum) {
+        std::string file(kFullPath);
+        std::string text = legacyFormat(LogLevel::INFO, message, file, kLine);
+        sink->write(LogLevel::INFO, text.data(), text.size());
+        sum += text.size();
+    };
+    
+    for (int round = 0; round <= rounds; ++round) {
+        double a = runThreads(threads, count, [&](size_t& sum) {
+            sum += legacyFormat(LogLevel::INFO, message, kFullPath, kLine).size();
+        }, checksum);
+        double b = runThreads(threads, count, [&](size_t& sum) {
+            sum += logger->formatMessage(LogLevel::INFO, message, base_name, kLine).size();
+        }, checksum);
+        double c = runThreads(threads, count, [&](size_t& sum) {
+            sum += logger->formatMessage(LogLevel::INFO, message, kFullPath, kLine).size();
+        }, checksum);
+        double d = runThreads(threads, count, legacy_write, checksum);
+        double e = runThreads(threads, count, [&](size_t& sum) {
+            logger->info(message, base_name, kLine);
+            sum += 1;
+        }, checksum);
+        
+        // 第 0 轮用于预热，不计入结果
+        if (round > 0) {
+            legacy_format.push_back(a);
+            cached_format.push_back(b);
+            cached_format_full_path.push_back(c);
+            legacy_log.push_back(d);
+            cached_log.push_back(e);
+        }
+    }
+    
+    std::cout << "每线程记录数: " << count << "，线程数: " << threads << "，轮数: " << rounds << std::endl;
+    std::cout << "格式化:" << std::endl;
+    printRow("原实现（完整路径）", legacy_format);
+    printRow("缓存前缀（文件名）", cached_format);
+    printRow("缓存前缀（完整路径）", cached_format_full_path);
+    std::cout << "格式化并写入丢弃输出:" << std::endl;
+    printRow("原实现（完整路径）", legacy_log);
+    printRow("Logger::info（文件名）", cached_log);
+    
+    // 输出校验和，防止编译器省略格式化
+    std::cout << "校验和: " << checksum + sink->bytes() << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file queue_bench.cpp
+ * @brief 离线消息队列基准测试
+ * 
+ * 对比原先基于 std::priority_queue 的队列（入队复制、按优先级堆排序）
+ * 与现在按优先级分道的环形缓冲区 MessageQueue（入队移动、各优先级内 FIFO），
+ * 分别测量混合优先级消息的入队和出队耗时。
+ * 
+ * 用法: ws_queue_bench [消息数] [负载字节数] [轮数]
+ */
+
+#include "business/message_queue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+using namespace cross_platform_websocket;
+
+namespace {
+
+/**
+ * @brief 原先的队列项：负载为 std::string，按优先级比较
+ */
+struct LegacyQueuedMessage {
+    std::string data;
+    MessageType type;
+    MessagePriority priority;
+    uint64_t timestamp;
+    SendCompletionCallback completion;
+    
+    LegacyQueuedMessage(const std::string& d, MessageType t, MessagePriority p)
+        : data(d), type(t), priority(p), timestamp(0) {}
+    
+    bool operator<(const LegacyQueuedMessage& other) const {
+        return static_cast<int>(priority) < static_cast<int>(other.priority);
+    }
+};
+
+/**
+ * @brief 一轮测试的耗时（纳秒）
+ */
+struct RoundResult {
+    uint64_t push_ns;
+    uint64_t pop_ns;
+    
+    RoundResult() : push_ns(0), pop_ns(0) {}
+};
+
+uint64_t elapsedNanos(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+MessagePriority priorityOf(size_t index) {
+    // 以普通优先级为主，混入少量低、高和紧急消息
+    static const MessagePriority kPattern[] = {
+        MessagePriority::NORMAL, MessagePriority::NORMAL, MessagePriority::LOW, MessagePriority::NORMAL,
+        MessagePriority::HIGH, MessagePriority::NORMAL, MessagePriority::NORMAL, MessagePriority::URGENT
+    };
+    return kPattern[index % (sizeof(kPattern) / sizeof(kPattern[0]))];
+}
+
+RoundResult runLegacy(size_t count, const std::string& payload, size_t& checksum) {
+    RoundResult result;
+    std::priority_queue<LegacyQueuedMessage> queue;
+    
+    // 与原实现一致：在栈上构造后以左值入队（复制负载）
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        LegacyQueuedMessage message(payload, MessageType::TEXT, priorityOf(i));
+        message.timestamp = i;
+        queue.push(message);
+    }
+    result.push_ns = elapsedNanos(start);
+    
+    start = std::chrono::steady_clock::now();
+    while (!queue.empty()) {
+        const LegacyQueuedMessage& message = queue.top();
+        checksum += message.data.size() + static_cast<size_t>(message.priority);
+        queue.pop();
+    }
+    result.pop_ns = elapsedNanos(start);
+    return result;
+}
+
+RoundResult runLanes(size_t count, const std::string& payload, size_t per_lane, size_t& checksum) {
+    RoundResult result;
+    MessageQueue queue;
+    queue.reserve(per_lane);
+    
+    // 与 WebSocketManager 一致：在锁外构造负载后移动入队
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        QueuedMessage message(Payload(payload), MessageType::TEXT, priorityOf(i));
+        message.timestamp = i;
+        queue.push(std::move(message));
+    }
+    result.push_ns = elapsedNanos(start);
+    
+    start = std::chrono::steady_clock::now();
+    QueuedMessage message;
+    while (queue.pop(message)) {
+        checksum += message.data.size() + static_cast<size_t>(message.priority);
+    }
+    result.pop_ns = elapsedNanos(start);
+    return result;
+}
+
+void printResult(const char* name, const std::vector<RoundResult>& rounds, size_t count) {
+    // 取各轮中位数，减少调度抖动的影响
+    std::vector<uint64_t> push;
+    std::vector<uint64_t> pop;
+    for (const auto& round : rounds) {
+        push.push_back(round.push_ns);
+        pop.push_back(round.pop_ns);
+    }
+    std::sort(push.begin(), push.end());
+    std::sort(pop.begin(), pop.end());
+    double push_per_op = static_cast<double>(push[push.size() / 2]) / static_cast<double>(count);
+    double pop_per_op = static_cast<double>(pop[pop.size() / 2]) / static_cast<double>(count);
+    
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << "入队 " << std::setw(8) << push_per_op << " ns/条  "
+              << "出队 " << std::setw(8) << pop_per_op << " ns/条  "
+              << "合计 " << std::setw(8) << push_per_op + pop_per_op << " ns/条" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    size_t payload_size = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 64;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 5;
+    if (count == 0 || rounds <= 0) {
+        std::cerr << "用法: " << argv[0] << " [消息数] [负载字节数] [轮数]" << std::endl;
+        return 2;
+    }
+    
+    std::string payload(payload_size, 'x');
+    size_t checksum = 0;
+    std::vector<RoundResult> legacy;
+    std::vector<RoundResult> lanes;
+    std::vector<RoundResult> presized;
+    
+    // 与 WebSocketManager::enableMessageQueue 相同的预分配（总量不超过 4096，平均分给各优先级），
+    // 超出后各优先级队列按倍数扩容；另测一组按消息数预分配、不扩容的稳态开销
+    size_t per_lane = (std::min<size_t>(count, 4096) + MessageQueue::kPriorityLevels - 1) /
+                      MessageQueue::kPriorityLevels;
+    
+    // 先各跑一轮预热内存池和分配器，不计入结果
+    runLegacy(count, payload, checksum);
+    runLanes(count, payload, per_lane, checksum);
+    for (int i = 0; i < rounds; ++i) {
+        legacy.push_back(runLegacy(count, payload, checksum));
+        lanes.push_back(runLanes(count, payload, per_lane, checksum));
+        presized.push_back(runLanes(count, payload, count, checksum));
+    }
+    
+    std::cout << "消息数: " << count << "，负载: " << payload_size << " 字节，轮数: " << rounds << std::endl;
+    printResult("priority_queue", legacy, count);
+    printResult("MessageQueue", lanes, count);
+    printResult("MessageQueue*", presized, count);
+    std::cout << "（* 按消息数预分配，不含扩容开销）" << std::endl;
+    
+    // 输出校验和，防止编译器省略出队循环
+    std::cout << "校验和: " << checksum << std::endl;
+    return 0;
+}
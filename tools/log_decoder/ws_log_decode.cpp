@@ -0,0 +1,273 @@
+/**
+ * @file ws_log_decode.cpp
+ * @brief 二进制日志解码工具
+ * 
+ * 读取 Logger::enableBinaryLog 生成的文件，按格式定义还原文本，
+ * 所有线程的记录按时间戳合并后输出，格式与文本日志一致：
+ *   时间 [级别] [文件:行号] [T线程] 消息
+ * 
+ * 用法: ws_log_decode <日志文件> [输出文件]
+ */
+
+#include "core/logger/binary_log_format.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cross_platform_websocket;
+
+namespace {
+
+/**
+ * @brief 格式定义
+ */
+struct Definition {
+    uint8_t level;
+    uint32_t line;
+    std::string file;
+    std::string format;
+};
+
+/**
+ * @brief 日志记录
+ */
+struct Entry {
+    uint32_t id;
+    uint64_t timestamp_ns;
+    uint32_t thread;
+    std::vector<std::string> args;
+};
+
+/**
+ * @brief 顺序读取文件内容，越界时返回 false
+ */
+class Reader {
+public:
+    explicit Reader(const std::vector<char>& data) : data_(data), position_(0) {}
+    
+    bool done() const { return position_ >= data_.size(); }
+    size_t position() const { return position_; }
+    
+    template <typename T>
+    bool read(T& value) {
+        if (data_.size() - position_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, &data_[position_], sizeof(T));
+        position_ += sizeof(T);
+        return true;
+    }
+    
+    bool readString(size_t length, std::string& value) {
+        if (data_.size() - position_ < length) {
+            return false;
+        }
+        value.assign(data_.data() + position_, length);
+        position_ += length;
+        return true;
+    }
+
+private:
+    const std::vector<char>& data_;
+    size_t position_;
+};
+
+const char* levelString(uint8_t level) {
+    switch (level) {
+        case 0:  return "DEBUG";
+        case 1:  return "INFO";
+        case 2:  return "WARN";
+        case 3:  return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+bool readDefinition(Reader& reader, std::map<uint32_t, Definition>& definitions) {
+    uint32_t id = 0;
+    uint16_t file_length = 0;
+    uint32_t format_length = 0;
+    Definition definition;
+    
+    if (!reader.read(id) || !reader.read(definition.level) || !reader.read(definition.line) ||
+        !reader.read(file_length) || !reader.readString(file_length, definition.file) ||
+        !reader.read(format_length) || !reader.readString(format_length, definition.format)) {
+        return false;
+    }
+    definitions[id] = definition;
+    return true;
+}
+
+bool readArgument(Reader& reader, std::string& text) {
+    char tag = 0;
+    if (!reader.read(tag)) {
+        return false;
+    }
+    
+    switch (tag) {
+        case binary_log::kArgInt: {
+            int64_t value = 0;
+            if (!reader.read(value)) {
+                return false;
+            }
+            text = std::to_string(static_cast<long long>(value));
+            return true;
+        }
+        case binary_log::kArgUint: {
+            uint64_t value = 0;
+            if (!reader.read(value)) {
+                return false;
+            }
+            text = std::to_string(static_cast<unsigned long long>(value));
+            return true;
+        }
+        case binary_log::kArgDouble: {
+            double value = 0;
+            if (!reader.read(value)) {
+                return false;
+            }
+            text = std::to_string(value);
+            return true;
+        }
+        case binary_log::kArgString: {
+            uint32_t length = 0;
+            return reader.read(length) && reader.readString(length, text);
+        }
+        default:
+            return false;
+    }
+}
+
+bool readEntry(Reader& reader, std::vector<Entry>& entries) {
+    Entry entry;
+    uint8_t argc = 0;
+    if (!reader.read(entry.id) || !reader.read(entry.timestamp_ns) ||
+        !reader.read(entry.thread) || !reader.read(argc)) {
+        return false;
+    }
+    
+    entry.args.resize(argc);
+    for (uint8_t i = 0; i < argc; ++i) {
+        if (!readArgument(reader, entry.args[i])) {
+            return false;
+        }
+    }
+    entries.push_back(std::move(entry));
+    return true;
+}
+
+std::string formatTime(uint64_t timestamp_ns) {
+    std::chrono::system_clock::time_point time{std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(timestamp_ns))};
+    std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    std::tm* tm = std::localtime(&seconds);
+    
+    std::ostringstream oss;
+    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
+    oss << "." << std::setfill('0') << std::setw(3) << (timestamp_ns / 1000000) % 1000;
+    return oss.str();
+}
+
+std::string baseName(const std::string& file) {
+    size_t pos = file.find_last_of("/\\");
+    return pos != std::string::npos ? file.substr(pos + 1) : file;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "用法: " << argv[0] << " <日志文件> [输出文件]" << std::endl;
+        return 2;
+    }
+    
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::cerr << "无法打开日志文件: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    
+    Reader reader(data);
+    char magic[sizeof(binary_log::kMagic)];
+    uint32_t version = 0;
+    if (!reader.read(magic) || std::memcmp(magic, binary_log::kMagic, sizeof(magic)) != 0 ||
+        !reader.read(version)) {
+        std::cerr << "不是二进制日志文件: " << argv[1] << std::endl;
+        return 1;
+    }
+    if (version != binary_log::kVersion) {
+        std::cerr << "不支持的日志版本: " << version << std::endl;
+        return 1;
+    }
+    
+    std::map<uint32_t, Definition> definitions;
+    std::vector<Entry> entries;
+    bool truncated = false;
+    while (!reader.done()) {
+        size_t record_start = reader.position();
+        char type = 0;
+        reader.read(type);
+        
+        bool ok = false;
+        if (type == binary_log::kRecordDefinition) {
+            ok = readDefinition(reader, definitions);
+        } else if (type == binary_log::kRecordEntry) {
+            ok = readEntry(reader, entries);
+        }
+        if (!ok) {
+            // 进程异常退出时文件末尾可能只写了半条记录
+            std::cerr << "记录在偏移 " << record_start << " 处损坏或不完整，停止解码" << std::endl;
+            truncated = true;
+            break;
+        }
+    }
+    
+    // 各线程的缓冲区整块写入，块之间按时间交错，需要按时间戳合并
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    
+    std::ofstream file_output;
+    if (argc >= 3) {
+        file_output.open(argv[2]);
+        if (!file_output) {
+            std::cerr << "无法打开输出文件: " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = argc >= 3 ? static_cast<std::ostream&>(file_output) : std::cout;
+    
+    size_t unknown = 0;
+    for (const Entry& entry : entries) {
+        auto it = definitions.find(entry.id);
+        if (it == definitions.end()) {
+            unknown++;
+            continue;
+        }
+        
+        const Definition& definition = it->second;
+        output << formatTime(entry.timestamp_ns)
+               << " [" << levelString(definition.level) << "] ";
+        if (!definition.file.empty() && definition.line > 0) {
+            output << "[" << baseName(definition.file) << ":" << definition.line << "] ";
+        }
+        output << "[T" << entry.thread << "] "
+               << binary_log::substitute(definition.format, entry.args.data(), entry.args.size())
+               << "\n";
+    }
+    output.flush();
+    
+    if (unknown > 0) {
+        std::cerr << unknown << " 条记录缺少格式定义，已跳过" << std::endl;
+    }
+    return truncated ? 1 : 0;
+}